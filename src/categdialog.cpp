@@ -162,9 +162,10 @@ void mmCategDialog::saveCurrentCollapseState()
 bool mmCategDialog::AppendSubcategoryItems(wxTreeItemId parent, const Model_Category::Data* category) {
     bool show_hidden_categs = m_tbShowAll->GetValue();
     bool catDisplayed = false;
+    const Model_Category::Usage& usage = Model_Category::usage();
     for (auto& subcat : m_categ_children[category->CATEGID]) {
         // Check if the subcategory should be shown
-        bool subcatDisplayed = (show_hidden_categs || subcat.ACTIVE.GetValue() || subcat.CATEGID == m_init_selected_categ_id) && Model_Category::full_name(subcat.CATEGID).Lower().Matches(m_maskStr + "*");
+        bool subcatDisplayed = (show_hidden_categs || subcat.ACTIVE.GetValue() || subcat.CATEGID == m_init_selected_categ_id) && usage.category_name(subcat.CATEGID).Lower().Matches(m_maskStr + "*");
         // Append it to get the item ID
         wxTreeItemId newId = m_treeCtrl->AppendItem(parent, subcat.CATEGNAME);
         // Check if any subcategories are not filtered out
@@ -194,6 +195,7 @@ void mmCategDialog::fillControls()
     bool show_hidden_categs = Model_Setting::instance().getBool("SHOW_HIDDEN_CATEGS", true);
 
     const wxString match = m_maskStr + "*";
+    const Model_Category::Usage& usage = Model_Category::usage();
     wxTreeItemId maincat = root_;
     m_categ_children.clear();
     for (Model_Category::Data cat : Model_Category::instance().all(Model_Category::COL_CATEGNAME)) {
@@ -203,7 +205,7 @@ void mmCategDialog::fillControls()
     for (auto& category : m_categ_children[-1])
     {
         bool cat_bShow = categShowStatus(category.CATEGID);
-        bool catDisplayed = (show_hidden_categs || cat_bShow || category.CATEGID == m_init_selected_categ_id) && Model_Category::full_name(category.CATEGID).Lower().Matches(match);
+        bool catDisplayed = (show_hidden_categs || cat_bShow || category.CATEGID == m_init_selected_categ_id) && usage.category_name(category.CATEGID).Lower().Matches(match);
 
         // Append top level category to root_ to get the item ID
         maincat = m_treeCtrl->AppendItem(root_, category.CATEGNAME);
@@ -1,7 +1,7 @@
 // -*- C++ -*-
 //=============================================================================
 /**
- *      Copyright: (c) 2013 - 2025 Guan Lisheng (guanlisheng@gmail.com)
+ *      Copyright: (c) 2013 - 2026 Guan Lisheng (guanlisheng@gmail.com)
  *      Copyright: (c) 2017 - 2018 Stefano Giorgio (stef145g)
  *      Copyright: (c) 2022 Mark Whalley (mark@ipx.co.uk)
  *
@@ -12,14 +12,17 @@
  *      @brief
  *
  *      Revision History:
- *          AUTO GENERATED at 2025-05-08 09:16:56.228434.
+ *          AUTO GENERATED at 2026-10-16 15:06:21.169201.
  *          DO NOT EDIT!
  */
 //=============================================================================
 #pragma once
 
+#include <array>
 #include <vector>
 #include <map>
+#include <unordered_map>
+#include <type_traits>
 #include <random>
 #include <algorithm>
 #include <functional>
@@ -50,18 +53,146 @@ struct DB_Column
     {}
 };
 
+/** Hash of the primary key, used by the in-memory index of each table */
+struct DB_Id_Hash
+{
+    size_t operator()(const int64& id) const
+    {
+        return std::hash<wxLongLong_t>()(id.GetValue());
+    }
+};
+
 static int64 ticks_last_ = 0;
+
+/** One entry of the change journal of a table */
+struct DB_Change
+{
+    enum TYPE { CHANGE_INSERT = 0, CHANGE_UPDATE, CHANGE_REMOVE, CHANGE_RESET };
+    size_t generation;
+    TYPE type;
+    int64 id; // the primary key, 0 for CHANGE_RESET
+};
     
 struct DB_Table
 {
-    DB_Table(): hit_(0), miss_(0), skip_(0) {};
+    static const size_t NO_SLOT = static_cast<size_t>(-1);
+
+    DB_Table(): hit_(0), miss_(0), skip_(0), generation_(0), stmt_hit_(0), stmt_miss_(0), stmt_db_(nullptr) {};
     virtual ~DB_Table() {};
     wxString query_;
     size_t hit_, miss_, skip_;
+    size_t generation_; // advanced by every save, remove and cache reset of the table
+
+    /** Change counter of the table, lets derived data tell whether it is stale */
+    size_t generation() const { return generation_; }
+
+    /** Latest changes of the table, at generation % JOURNAL_SIZE */
+    static const size_t JOURNAL_SIZE = 256;
+    std::array<DB_Change, JOURNAL_SIZE> journal_;
+
+    /** Advance the generation and record the change in the journal */
+    void journal(DB_Change::TYPE type, const int64& id)
+    {
+        ++ generation_;
+        journal_[generation_ % JOURNAL_SIZE] = { generation_, type, id };
+    }
+
+    /**
+    * Append the changes made after generation since, oldest first.
+    * Return false when the journal no longer holds all of them or one is a cache reset,
+    * then derived data has to be rebuilt.
+    */
+    bool changes_since(size_t since, std::vector<DB_Change>& changes) const
+    {
+        if (since > generation_ || generation_ - since > JOURNAL_SIZE)
+            return false;
+        for (size_t g = since + 1; g <= generation_; ++g)
+        {
+            const DB_Change& change = journal_[g % JOURNAL_SIZE];
+            if (change.type == DB_Change::CHANGE_RESET)
+                return false;
+            changes.push_back(change);
+        }
+        return true;
+    }
+
     virtual wxString query() const { return this->query_; }
     virtual size_t num_columns() const = 0;
     virtual wxString name() const = 0;
 
+    /** Prepared statements of the table, keyed by their SQL text */
+    typedef std::map<wxString, wxSQLite3Statement> Statement_Cache;
+    Statement_Cache stmt_cache_;
+    size_t stmt_hit_, stmt_miss_;
+    wxSQLite3Database* stmt_db_; // connection the cached statements belong to
+
+    /**
+    * Return the prepared statement for the sql text, ready to be bound.
+    * The statement is prepared on first use and reset on every reuse.
+    */
+    wxSQLite3Statement& statement(wxSQLite3Database* db, const wxString& sql)
+    {
+        if (db != stmt_db_)
+        {
+            destroy_statements();
+            stmt_db_ = db;
+        }
+
+        if (auto it = stmt_cache_.find(sql); it != stmt_cache_.end())
+        {
+            ++ stmt_hit_;
+            it->second.Reset();
+            return it->second;
+        }
+
+        ++ stmt_miss_;
+        return stmt_cache_.insert(std::make_pair(sql, db->PrepareStatement(sql))).first->second;
+    }
+
+    /** Finalize all cached statements, must be called before the connection is closed */
+    void destroy_statements()
+    {
+        stmt_cache_.clear();
+        stmt_db_ = nullptr;
+    }
+
+#ifndef NDEBUG
+    /** Index advisor: query plan and use count of each WHERE signature issued by find_by() */
+    struct Query_Plan
+    {
+        wxString detail;
+        size_t count = 0;
+        bool scan = false;
+    };
+    std::map<wxString, Query_Plan> query_plans_;
+
+    /** Record one use of the WHERE signature, explaining its plan on first sight */
+    void advise(wxSQLite3Database* db, const wxString& where)
+    {
+        Query_Plan& plan = query_plans_[where];
+        if (plan.count++ > 0) return;
+
+        try
+        {
+            wxSQLite3ResultSet q = db->ExecuteQuery("EXPLAIN QUERY PLAN " + this->query() + where);
+            while (q.NextRow())
+            {
+                const wxString detail = q.GetAsString(3);
+                plan.detail += (plan.detail.empty() ? "" : "; ") + detail;
+                if (detail.StartsWith("SCAN") && !detail.Contains(" INDEX "))
+                    plan.scan = true;
+            }
+        }
+        catch (const wxSQLite3Exception& e)
+        {
+            plan.detail = e.GetMessage();
+        }
+
+        if (plan.scan)
+            wxLogDebug("%s: full table scan for%s(%s)", this->name(), where, plan.detail);
+    }
+#endif
+
     bool exists(wxSQLite3Database* db) const
     {
        return db->TableExists(this->name()); 
@@ -143,9 +274,15 @@ const typename TABLE::Data_Set find_by(TABLE* table, wxSQLite3Database* db, bool
     typename TABLE::Data_Set result;
     try
     {
-        wxString query = table->query() + " WHERE ";
-        condition(query, op_and, args...);
-        wxSQLite3Statement stmt = db->PrepareStatement(query);
+        wxString where = " WHERE ";
+        condition(where, op_and, args...);
+#ifndef NDEBUG
+        table->advise(db, where);
+#endif
+        const wxString query = table->query() + where;
+        // the condition text only depends on the column pack and operators,
+        // so it doubles as the statement cache key
+        wxSQLite3Statement& stmt = table->statement(db, query);
         bind(stmt, 1, args...);
 
         wxSQLite3ResultSet q = stmt.ExecuteQuery();
@@ -156,7 +293,7 @@ const typename TABLE::Data_Set find_by(TABLE* table, wxSQLite3Database* db, bool
             result.push_back(std::move(entity));
         }
 
-        q.Finalize();
+        stmt.Reset();
     }
     catch(const wxSQLite3Exception &e) 
     { 
@@ -166,6 +303,41 @@ const typename TABLE::Data_Set find_by(TABLE* table, wxSQLite3Database* db, bool
     return result;
 }
 
+/** True when the column type C is one of the argument types */
+template<typename C, typename... Args>
+constexpr bool has_column = (std::is_same_v<C, Args> || ...);
+
+template<typename C, typename Arg>
+const C* column_arg_if(const Arg& arg)
+{
+    if constexpr (std::is_same_v<C, Arg>) return &arg;
+    else return nullptr;
+}
+
+/** Return the first argument of column type C, or nullptr */
+template<typename C, typename... Args>
+const C* column_arg(const Args&... args)
+{
+    const C* found = nullptr;
+    ((found = found ? found : column_arg_if<C>(args)), ...);
+    return found;
+}
+
+/** Remove the entry of the record from a secondary index */
+template<class INDEX, class DATA>
+void erase_from_index(INDEX& index, const typename INDEX::key_type& key, const DATA* entity)
+{
+    auto range = index.equal_range(key);
+    for (auto it = range.first; it != range.second; ++ it)
+    {
+        if (it->second == entity)
+        {
+            index.erase(it);
+            return;
+        }
+    }
+}
+
 template<class DATA, typename Arg1>
 bool match(const DATA* data, const Arg1& arg1)
 {
@@ -1,7 +1,7 @@
 ﻿// -*- C++ -*-
 //=============================================================================
 /**
- *      Copyright: (c) 2013 - 2025 Guan Lisheng (guanlisheng@gmail.com)
+ *      Copyright: (c) 2013 - 2026 Guan Lisheng (guanlisheng@gmail.com)
  *      Copyright: (c) 2017 - 2018 Stefano Giorgio (stef145g)
  *      Copyright: (c) 2022 Mark Whalley (mark@ipx.co.uk)
  *
@@ -12,7 +12,7 @@
  *      @brief
  *
  *      Revision History:
- *          AUTO GENERATED at 2025-05-08 09:16:56.228434.
+ *          AUTO GENERATED at 2026-10-16 15:06:21.169201.
  *          DO NOT EDIT!
  */
 //=============================================================================
@@ -47,9 +47,13 @@ struct DB_Table_ATTACHMENT_V1 : public DB_Table
         }
     };
 
-    /** A container to hold a list of Data record pointers for the table in memory*/
+    /**
+    * A container to hold a list of Data record pointers for the table in memory.
+    * Each cached record knows its own slot in the cache, so that it can be
+    * located and released in constant time.
+    */
     typedef std::vector<Self::Data*> Cache;
-    typedef std::map<int64, Self::Data*> Index_By_Id;
+    typedef std::unordered_map<int64, Self::Data*, DB_Id_Hash> Index_By_Id;
     Cache cache_;
     Index_By_Id index_by_id_;
     Data* fake_; // in case the entity not found
@@ -67,6 +71,37 @@ struct DB_Table_ATTACHMENT_V1 : public DB_Table
         std::for_each(cache_.begin(), cache_.end(), std::mem_fn(&Data::destroy));
         cache_.clear();
         index_by_id_.clear(); // no memory release since it just stores pointer and the according objects are in cache
+        destroy_statements();
+        journal(DB_Change::CHANGE_RESET, 0);
+    }
+
+    /** Take ownership of the record by placing it in the memory table (cache)*/
+    void attach(Self::Data* entity)
+    {
+        entity->slot_ = cache_.size();
+        cache_.push_back(entity);
+    }
+
+    /** Release the record from the memory table (cache), filling its slot with the last record*/
+    void detach(Self::Data* entity)
+    {
+        Self::Data* last = cache_.back();
+        cache_[entity->slot_] = last;
+        last->slot_ = entity->slot_;
+        cache_.pop_back();
+        entity->slot_ = NO_SLOT;
+    }
+
+    /** Add the cached record to the memory table indexes*/
+    void index(Self::Data* entity)
+    {
+        index_by_id_.insert(std::make_pair(entity->id(), entity));
+    }
+
+    /** Remove the cached record from the memory table indexes*/
+    void unindex(Self::Data* entity)
+    {
+        index_by_id_.erase(entity->id());
     }
 
     /** Creates the database table if the table does not exist*/
@@ -186,6 +221,8 @@ struct DB_Table_ATTACHMENT_V1 : public DB_Table
         friend struct DB_Table_ATTACHMENT_V1;
         /** This is a instance pointer to itself in memory. */
         Self* table_;
+        /** Position of the record in the table cache, NO_SLOT if not owned by the cache. */
+        size_t slot_;
     
         int64 ATTACHMENTID;//  primary key
         wxString REFTYPE;
@@ -226,6 +263,7 @@ struct DB_Table_ATTACHMENT_V1 : public DB_Table
         explicit Data(Self* table = nullptr ) 
         {
             table_ = table;
+            slot_ = NO_SLOT;
         
             ATTACHMENTID = -1;
             REFID = -1;
@@ -234,6 +272,7 @@ struct DB_Table_ATTACHMENT_V1 : public DB_Table
         explicit Data(wxSQLite3ResultSet& q, Self* table = nullptr )
         {
             table_ = table;
+            slot_ = NO_SLOT;
         
             ATTACHMENTID = q.GetInt64(0); // ATTACHMENTID
             REFTYPE = q.GetString(1); // REFTYPE
@@ -242,7 +281,12 @@ struct DB_Table_ATTACHMENT_V1 : public DB_Table
             FILENAME = q.GetString(4); // FILENAME
         }
 
-        Data(const Data& other) = default;
+        Data(const Data& other)
+        {
+            table_ = other.table_;
+            slot_ = NO_SLOT; // a copy is never owned by the cache
+            *this = other;
+        }
 
         Data& operator=(const Data& other)
         {
@@ -385,7 +429,7 @@ struct DB_Table_ATTACHMENT_V1 : public DB_Table
     Self::Data* create()
     {
         Self::Data* entity = new Self::Data(this);
-        cache_.push_back(entity);
+        attach(entity);
         return entity;
     }
     
@@ -401,12 +445,13 @@ struct DB_Table_ATTACHMENT_V1 : public DB_Table
     /**
     * Saves the Data record to the database table.
     * Either create a new record or update the existing record.
-    * Remove old record from the memory table (cache)
+    * Update the cached record in place, or index a newly created one.
     */
     bool save(Self::Data* entity, wxSQLite3Database* db, bool force_insert = false)
     {
         wxString sql = wxEmptyString;
-        if (entity->id() <= 0 || force_insert) //  new & insert
+        const bool insert = entity->id() <= 0 || force_insert;
+        if (insert) //  new & insert
         {
             sql = "INSERT INTO ATTACHMENT_V1(REFTYPE, REFID, DESCRIPTION, FILENAME, ATTACHMENTID) VALUES(?, ?, ?, ?, ?)";
         }
@@ -417,7 +462,7 @@ struct DB_Table_ATTACHMENT_V1 : public DB_Table
 
         try
         {
-            wxSQLite3Statement stmt = db->PrepareStatement(sql);
+            wxSQLite3Statement& stmt = statement(db, sql);
 
             stmt.Bind(1, entity->REFTYPE);
             stmt.Bind(2, entity->REFID);
@@ -426,15 +471,21 @@ struct DB_Table_ATTACHMENT_V1 : public DB_Table
             stmt.Bind(5, entity->id() > 0 ? entity->ATTACHMENTID : newId());
 
             stmt.ExecuteUpdate();
-            stmt.Finalize();
+            stmt.Reset();
 
             if (entity->id() > 0) // existent
             {
-                for(Cache::iterator it = cache_.begin(); it != cache_.end(); ++ it)
+                if (auto it = index_by_id_.find(entity->id()); it != index_by_id_.end())
                 {
-                    Self::Data* e = *it;
-                    if (e->id() == entity->id()) 
+                    Self::Data* e = it->second;
+                    unindex(e);
+                    if (e != entity)
                         *e = *entity;  // in-place update
+                    index(e);
+                }
+                else if (entity->slot_ != NO_SLOT)
+                {
+                    index(entity);
                 }
             }
         }
@@ -447,8 +498,10 @@ struct DB_Table_ATTACHMENT_V1 : public DB_Table
         if (entity->id() <= 0)
         {
             entity->id(db->GetLastRowId());
-            index_by_id_.insert(std::make_pair(entity->id(), entity));
+            if (entity->slot_ != NO_SLOT) // only records owned by the cache are indexed
+                index(entity);
         }
+        journal(insert ? DB_Change::CHANGE_INSERT : DB_Change::CHANGE_UPDATE, entity->id());
         return true;
     }
 
@@ -459,27 +512,18 @@ struct DB_Table_ATTACHMENT_V1 : public DB_Table
         try
         {
             wxString sql = "DELETE FROM ATTACHMENT_V1 WHERE ATTACHMENTID = ?";
-            wxSQLite3Statement stmt = db->PrepareStatement(sql);
+            wxSQLite3Statement& stmt = statement(db, sql);
             stmt.Bind(1, id);
             stmt.ExecuteUpdate();
-            stmt.Finalize();
+            stmt.Reset();
 
-            Cache c;
-            for(Cache::iterator it = cache_.begin(); it != cache_.end(); ++ it)
+            if (auto it = index_by_id_.find(id); it != index_by_id_.end())
             {
-                Self::Data* entity = *it;
-                if (entity->id() == id) 
-                {
-                    index_by_id_.erase(entity->id());
-                    delete entity;
-                }
-                else 
-                {
-                    c.push_back(entity);
-                }
+                Self::Data* entity = it->second;
+                unindex(entity);
+                if (entity->slot_ != NO_SLOT) detach(entity);
+                delete entity;
             }
-            cache_.clear();
-            cache_.swap(c);
         }
         catch(const wxSQLite3Exception &e) 
         { 
@@ -487,36 +531,42 @@ struct DB_Table_ATTACHMENT_V1 : public DB_Table
             return false;
         }
 
+        journal(DB_Change::CHANGE_REMOVE, id);
         return true;
     }
 
     /** Remove the Data record from the database and the memory table (cache) */
     bool remove(Self::Data* entity, wxSQLite3Database* db)
     {
+        auto it = index_by_id_.find(entity->id());
+        const bool cached = (it != index_by_id_.end() && it->second == entity);
         if (remove(entity->id(), db))
         {
-            entity->id(-1);
+            if (!cached) entity->id(-1); // a cached entity has been released
             return true;
         }
 
         return false;
     }
 
+    /**
+    * Search the memory table (Cache) for the first data record matching all arguments.
+    * A secondary index is used when the arguments cover its columns with EQUAL.
+    */
     template<typename... Args>
     Self::Data* get_one(const Args& ... args)
     {
+        // the id index is unordered, keep the lowest id among the matches
+        Self::Data* found = 0;
         for (auto& [_, item] : index_by_id_)
         {
-            if (item->id() > 0 && match(item, args...)) 
-            {
-                ++ hit_;
-                return item;
-            }
+            if (item->id() > 0 && match(item, args...) && (!found || item->id() < found->id()))
+                found = item;
         }
 
-        ++ miss_;
+        if (found) ++ hit_; else ++ miss_;
 
-        return 0;
+        return found;
     }
     
     /**
@@ -542,17 +592,17 @@ struct DB_Table_ATTACHMENT_V1 : public DB_Table
         wxString where = wxString::Format(" WHERE %s = ?", PRIMARY::name().utf8_str());
         try
         {
-            wxSQLite3Statement stmt = db->PrepareStatement(this->query() + where);
+            wxSQLite3Statement& stmt = statement(db, this->query() + where);
             stmt.Bind(1, id);
 
             wxSQLite3ResultSet q = stmt.ExecuteQuery();
             if(q.NextRow())
             {
                 entity = new Self::Data(q, this);
-                cache_.push_back(entity);
-                index_by_id_.insert(std::make_pair(id, entity));
+                attach(entity);
+                index(entity);
             }
-            stmt.Finalize();
+            stmt.Reset();
         }
         catch(const wxSQLite3Exception &e) 
         { 
@@ -582,7 +632,7 @@ struct DB_Table_ATTACHMENT_V1 : public DB_Table
         wxString where = wxString::Format(" WHERE %s = ?", PRIMARY::name().utf8_str());
         try
         {
-            wxSQLite3Statement stmt = db->PrepareStatement(this->query() + where);
+            wxSQLite3Statement& stmt = statement(db, this->query() + where);
             stmt.Bind(1, id);
 
             wxSQLite3ResultSet q = stmt.ExecuteQuery();
@@ -590,7 +640,7 @@ struct DB_Table_ATTACHMENT_V1 : public DB_Table
             {
                 entity = new Self::Data(q, this);
             }
-            stmt.Finalize();
+            stmt.Reset();
         }
         catch(const wxSQLite3Exception &e) 
         { 
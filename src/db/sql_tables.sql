@@ -66,6 +66,8 @@ BDID integer primary key
 , COLOR integer DEFAULT -1
 );
 CREATE INDEX IDX_BILLSDEPOSITS_ACCOUNT ON BILLSDEPOSITS_V1 (ACCOUNTID, TOACCOUNTID);
+CREATE INDEX IDX_BILLSDEPOSITS_PAYEEID ON BILLSDEPOSITS_V1 (PAYEEID);
+CREATE INDEX IDX_BILLSDEPOSITS_CATEGID ON BILLSDEPOSITS_V1 (CATEGID);
 
 -- Describe BUDGETSPLITTRANSACTIONS_V1
 CREATE TABLE BUDGETSPLITTRANSACTIONS_V1(
@@ -76,6 +78,7 @@ SPLITTRANSID integer primary key
 , NOTES TEXT
 );
 CREATE INDEX IDX_BUDGETSPLITTRANSACTIONS_TRANSID ON BUDGETSPLITTRANSACTIONS_V1(TRANSID);
+CREATE INDEX IDX_BUDGETSPLITTRANSACTIONS_CATEGID ON BUDGETSPLITTRANSACTIONS_V1(CATEGID);
 
 -- Describe BUDGETTABLE_V1
 CREATE TABLE BUDGETTABLE_V1(
@@ -106,6 +109,7 @@ CREATE TABLE CATEGORY_V1
 );
 CREATE INDEX IDX_CATEGORY_CATEGNAME ON CATEGORY_V1(CATEGNAME);
 CREATE INDEX IDX_CATEGORY_CATEGNAME_PARENTID ON CATEGORY_V1(CATEGNAME, PARENTID);
+CREATE INDEX IDX_CATEGORY_PARENTID ON CATEGORY_V1(PARENTID);
 
 -- Note: All strings requiring translation are prefix by: ''
 -- The  prefix is removed when generating .h files by sqlite2cpp.py
@@ -199,6 +203,8 @@ TRANSID integer primary key
 );
 CREATE INDEX IDX_CHECKINGACCOUNT_ACCOUNT ON CHECKINGACCOUNT_V1 (ACCOUNTID, TOACCOUNTID);
 CREATE INDEX IDX_CHECKINGACCOUNT_TRANSDATE ON CHECKINGACCOUNT_V1 (TRANSDATE);
+CREATE INDEX IDX_CHECKINGACCOUNT_PAYEEID ON CHECKINGACCOUNT_V1 (PAYEEID, DELETEDTIME);
+CREATE INDEX IDX_CHECKINGACCOUNT_CATEGID ON CHECKINGACCOUNT_V1 (CATEGID, DELETEDTIME);
 
 -- Describe CURRENCYHISTORY_V1
 CREATE TABLE CURRENCYHISTORY_V1(
@@ -432,6 +438,7 @@ SPLITTRANSID integer primary key
 , NOTES TEXT
 );
 CREATE INDEX IDX_SPLITTRANSACTIONS_TRANSID ON SPLITTRANSACTIONS_V1(TRANSID);
+CREATE INDEX IDX_SPLITTRANSACTIONS_CATEGID ON SPLITTRANSACTIONS_V1(CATEGID);
 
 -- Describe STOCK_V1
 CREATE TABLE STOCK_V1(
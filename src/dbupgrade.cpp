@@ -21,13 +21,18 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #include "dbupgrade.h"
 #include "constants.h"
 #include "util.h"
+#include "model/Model_Setting.h"
 
+#include <wx/dir.h>
 #include <wx/filedlg.h>
 #include <wx/filename.h>
 #include <wx/msgdlg.h>
 #include <wx/textdlg.h>
 #include <wx/textfile.h>
 #include <wx/tokenzr.h>
+#include <wx/wfstream.h>
+#include <wx/zstream.h>
+#include <atomic>
 
 int dbUpgrade::GetCurrentVersion(wxSQLite3Database * db)
 {
@@ -124,30 +129,168 @@ bool dbUpgrade::UpgradeDB(wxSQLite3Database * db, const wxString& DbFileName)
     return true;
 }
 
+namespace
+{
+    std::atomic<int> backup_progress(-1);
+
+    class BackupProgressHandler : public wxSQLite3BackupProgress
+    {
+    public:
+        bool Progress(int totalPages, int remainingPages) override
+        {
+            if (totalPages > 0)
+                backup_progress = 100 - static_cast<int>(100LL * remainingPages / totalPages);
+            return true;
+        }
+    };
+
+    /** Copy a database with the SQLite online backup API, a batch of pages per step */
+    bool BackupCopy(const wxString& source, const wxString& target, bool compress)
+    {
+        const wxString copy = compress ? target + ".tmp" : target;
+        try
+        {
+            wxSQLite3Database db;
+            db.Open(source, wxEmptyString, WXSQLITE_OPEN_READONLY);
+            db.SetBackupRestorePageCount(256);
+            BackupProgressHandler progress;
+            backup_progress = 0;
+            db.Backup(&progress, copy);
+            db.Close();
+        }
+        catch (const wxSQLite3Exception& e)
+        {
+            wxLogError("Backup of %s failed: %s", source, e.GetMessage());
+            backup_progress = -1;
+            if (wxFileExists(copy)) wxRemoveFile(copy);
+            return false;
+        }
+        backup_progress = -1;
+
+        if (!compress)
+            return true;
+
+        bool done = false;
+        {
+            wxFFileInputStream in(copy);
+            wxFFileOutputStream out(target);
+            if (in.IsOk() && out.IsOk())
+            {
+                wxZlibOutputStream gzip(out, wxZ_DEFAULT_COMPRESSION, wxZLIB_GZIP);
+                gzip.Write(in);
+                done = gzip.Close() && out.Close();
+            }
+        }
+        wxRemoveFile(copy);
+        if (!done)
+        {
+            wxLogError("Backup of %s could not be compressed", source);
+            if (wxFileExists(target)) wxRemoveFile(target);
+        }
+        return done;
+    }
+
+    /** Keep only the newest backups of the given kind */
+    void BackupCleanup(const wxString& FileName, const wxString& BackupName, int FilesToKeep)
+    {
+        const wxFileName fn(FileName);
+        wxArrayString found;
+        for (const wxString& ext : { ".bak", ".bak.gz" })
+        {
+            const wxString fileSearch = wxString::Format("%s%s????-??-??%s", fn.GetFullName(), BackupName, ext);
+            wxDir::GetAllFiles(fn.GetPath(), &found, fileSearch, wxDIR_FILES);
+        }
+
+        wxSortedArrayString backupFileArray;
+        for (const auto& file : found)
+            backupFileArray.Add(file);
+
+        while (backupFileArray.GetCount() > static_cast<size_t>(FilesToKeep))
+        {
+            wxFileName fnLastFile(backupFileArray.Item(0));
+            wxLogDebug("%s", backupFileArray.Item(0));
+            // ensure file is not read only before deleting file.
+            if (fnLastFile.IsFileWritable())
+                wxRemoveFile(backupFileArray.Item(0));
+
+            backupFileArray.erase(backupFileArray.begin());
+        }
+    }
+
+    class BackupThread : public wxThread
+    {
+    public:
+        BackupThread(const wxString& source, const wxString& target, bool compress
+            , const wxString& backupName, int filesToKeep)
+            : wxThread(wxTHREAD_JOINABLE)
+            , m_source(source), m_target(target), m_compress(compress)
+            , m_backupName(backupName), m_filesToKeep(filesToKeep)
+        {}
+
+    protected:
+        ExitCode Entry() override
+        {
+            wxLogDebug("Backup %s to %s (thread %lu)", m_source, m_target, GetId());
+            if (BackupCopy(m_source, m_target, m_compress))
+                BackupCleanup(m_source, m_backupName, m_filesToKeep);
+            return nullptr;
+        }
+
+    private:
+        wxString m_source, m_target;
+        bool m_compress;
+        wxString m_backupName;
+        int m_filesToKeep;
+    };
+
+    std::vector<BackupThread*> backup_threads;
+}
+
+/*
+* Backups are taken with the SQLite online backup API through a read only connection,
+* so a database being written is never captured half way. The startup and upgrade
+* backups must hold the state before the database is modified and run in place;
+* the backup on close runs in the background, see WaitForBackups().
+* Encrypted databases are copied as files, the backup API would store them decrypted.
+*/
 void dbUpgrade::BackupDB(const wxString& FileName, int BackupType, int FilesToKeep, int UpgradeVersion)
 {
     wxFileName fn(FileName);
     if (!fn.IsOk()) return;
 
+    const bool encrypted = fn.GetExt().Lower() == "emb";
+    const bool compress = !encrypted && Model_Setting::instance().getBool("BACKUPDB_COMPRESS", false);
     const wxString BackupName[3] = { "_start_", "_update_", wxString::Format("_upgrade_v%i_", UpgradeVersion) };
-    const auto backupFileName = wxString::Format("%s%s%s.bak", FileName, BackupName[BackupType], wxDateTime().Today().FormatISODate());
+    const auto backupFileName = wxString::Format("%s%s%s.bak%s", FileName, BackupName[BackupType]
+        , wxDateTime().Today().FormatISODate(), compress ? ".gz" : "");
     wxFileName fnBak(backupFileName);
 
     // process backup
     switch (BackupType)
     {
     case BACKUPTYPE::START:
-        if (!fnBak.FileExists()) {
+    case BACKUPTYPE::VERSION_UPGRADE:
+        if (fnBak.FileExists())
+            break;
+        if (encrypted)
             wxCopyFile(FileName, backupFileName, true);
-        }
+        else
+            BackupCopy(FileName, backupFileName, compress);
         break;
     case BACKUPTYPE::CLOSE:
-        wxCopyFile(FileName, backupFileName, true);
-        break;
-    case BACKUPTYPE::VERSION_UPGRADE:
-        if (!fnBak.FileExists()) {
-            wxCopyFile(FileName, backupFileName, true);
+        if (!encrypted)
+        {
+            BackupThread* thread = new BackupThread(FileName, backupFileName, compress, BackupName[BackupType], FilesToKeep);
+            if (thread->Run() == wxTHREAD_NO_ERROR)
+            {
+                backup_threads.push_back(thread);
+                return; // old backups are cleaned up by the thread
+            }
+            delete thread;
+            BackupCopy(FileName, backupFileName, compress);
         }
+        else
+            wxCopyFile(FileName, backupFileName, true);
         break;
     default:
         break;
@@ -155,27 +298,24 @@ void dbUpgrade::BackupDB(const wxString& FileName, int BackupType, int FilesToKe
 
     // Cleanup old backups
     if (BackupType != BACKUPTYPE::VERSION_UPGRADE)
-    {
-        wxSortedArrayString backupFileArray;
-        const auto fileSearch = wxString::Format(R"(%s%s????-??-??.bak)", FileName, BackupName[BackupType]);
-        wxString backupFile = wxFindFirstFile(fileSearch);
-        while (!backupFile.empty())
-        {
-            backupFileArray.Add(backupFile);
-            backupFile = wxFindNextFile();
-        }
-
-        while (backupFileArray.GetCount() > static_cast<size_t>(FilesToKeep))
-        {
-            wxFileName fnLastFile(backupFileArray.Item(0));
-            wxLogDebug("%s", backupFileArray.Item(0));
-            // ensure file is not read only before deleting file.
-            if (fnLastFile.IsFileWritable())
-                wxRemoveFile(backupFileArray.Item(0));
+        BackupCleanup(FileName, BackupName[BackupType], FilesToKeep);
+}
 
-            backupFileArray.erase(backupFileArray.begin());
-        }
+void dbUpgrade::WaitForBackups()
+{
+    for (auto thread : backup_threads)
+    {
+        if (thread->IsRunning())
+            wxLogDebug("Waiting for backup, %i%% done", BackupProgress());
+        thread->Wait();
+        delete thread;
     }
+    backup_threads.clear();
+}
+
+int dbUpgrade::BackupProgress()
+{
+    return backup_progress;
 }
 
 void dbUpgrade::SqlFileDebug(wxSQLite3Database * db)
@@ -32,6 +32,10 @@ public:
     static bool isUpgradeDBrequired(wxSQLite3Database* db);
     static bool UpgradeDB(wxSQLite3Database* db, const wxString& DbFileName);
     static void BackupDB(const wxString& Filename, int BackupType, int FilesToKeep, int UpgradeVersion = 0);
+    /** Wait for the backups still running in the background */
+    static void WaitForBackups();
+    /** Percentage done of the running backup, -1 when idle */
+    static int BackupProgress();
     enum BACKUPTYPE { START = 0, CLOSE, VERSION_UPGRADE };
     static void SqlFileDebug(wxSQLite3Database * db);
 };
@@ -174,6 +174,7 @@ int mmFilterTransactionsDialog::ShowModal()
 
 void mmFilterTransactionsDialog::mmDoDataToControls(const wxString& json)
 {
+    m_compiled_valid = false;
     Document j_doc;
     if (j_doc.Parse(json.utf8_str()).HasParseError())
     {
@@ -1127,6 +1128,7 @@ void mmFilterTransactionsDialog::OnButtonOkClick(wxCommandEvent& /*event*/)
     if (mmIsValuesCorrect())
     {
         mmDoSaveSettings();
+        mmCompileFilter();
         EndModal(wxID_OK);
     }
 }
@@ -1237,7 +1239,7 @@ const wxString mmFilterTransactionsDialog::mmGetStatus() const
 
 bool mmFilterTransactionsDialog::mmIsStatusMatches(const wxString& itemStatus) const
 {
-    wxString filterStatus = mmGetStatus();
+    const wxString& filterStatus = m_compiled.status_key;
     if (itemStatus == filterStatus)
     {
         return true;
@@ -1324,94 +1326,153 @@ void mmFilterTransactionsDialog::OnButtonClearClick(wxCommandEvent& /*event*/)
     }
 }
 
-bool mmFilterTransactionsDialog::mmIsPayeeMatches(int64 payeeID)
+/** Merge the tags of each split with the tags of its transaction, and the other way round */
+template <class SPLIT_MODEL>
+void mmFilterTransactionsDialog::mmMergeSplitTags(Compiled& f, const wxString& tranRefType)
 {
-    const Model_Payee::Data* payee = Model_Payee::instance().get(payeeID);
-    if (payee)
+    const std::unordered_map<int64, std::set<wxString> > none;
+    const auto tran_it = f.tagnames.find(tranRefType);
+    const auto& tran_tags = (tran_it != f.tagnames.end()) ? tran_it->second : none;
+    auto& split_tags = f.tagnames[SPLIT_MODEL::refTypeName];
+    auto& merged = f.merged_tagnames[tranRefType];
+    merged = tran_tags;
+    if (tran_tags.empty() && split_tags.empty())
+        return;
+
+    const auto own_tags = split_tags;
+    for (const auto& split : SPLIT_MODEL::instance().all())
     {
-        const wxString value = cbPayee_->mmGetPattern();
-        if (!value.empty())
-        {
-            wxRegEx pattern("^(" + value + ")$", wxRE_ICASE | wxRE_ADVANCED);
-            if (pattern.IsValid() && pattern.Matches(payee->PAYEENAME))
-            {
-                return true;
-            }
-        }
+        const auto own = own_tags.find(split.SPLITTRANSID);
+        if (own != own_tags.end())
+            merged[split.TRANSID].insert(own->second.begin(), own->second.end());
+        const auto parent = tran_tags.find(split.TRANSID);
+        if (parent != tran_tags.end())
+            split_tags[split.SPLITTRANSID].insert(parent->second.begin(), parent->second.end());
     }
-    return false;
 }
 
-bool mmFilterTransactionsDialog::mmIsNoteMatches(const wxString& note)
+// Compile the filter values once per filter run; payee names are matched
+// here against all payees, so a run also picks up payees added since the last one
+void mmFilterTransactionsDialog::mmCompileFilter()
+{
+    Compiled f;
+
+    f.account = mmIsAccountChecked();
+    f.account_ids.insert(m_selected_accounts_id.begin(), m_selected_accounts_id.end());
+    f.dates = mmIsDateRangeChecked() || mmIsRangeChecked();
+
+    f.payee = mmIsPayeeChecked();
+    const wxString payee_pattern = cbPayee_->mmGetPattern();
+    if (f.payee && !payee_pattern.empty())
+    {
+        wxRegEx pattern("^(" + payee_pattern + ")$", wxRE_ICASE | wxRE_ADVANCED);
+        if (pattern.IsValid())
+            for (const auto& payee : Model_Payee::instance().all())
+                if (pattern.Matches(payee.PAYEENAME))
+                    f.payee_ids.insert(payee.PAYEEID);
+    }
+
+    f.category = mmIsCategoryChecked();
+    f.category_ids.insert(m_selected_categories_id.begin(), m_selected_categories_id.end());
+
+    f.status = mmIsStatusChecked();
+    f.status_key = mmGetStatus();
+
+    f.amount_min = mmIsAmountRangeMinChecked();
+    f.amount_min_value = f.amount_min ? mmGetAmountMin() : 0.0;
+    f.amount_max = mmIsAmountRangeMaxChecked();
+    f.amount_max_value = f.amount_max ? mmGetAmountMax() : 0.0;
+
+    f.number = mmIsNumberChecked();
+    f.number_empty = mmGetNumber().empty();
+    if (f.number && !f.number_empty)
+        f.number_pattern = mmCompileWildcard(mmGetNumber());
+
+    f.notes = mmIsNotesChecked();
+    const wxString notes = mmGetNotes();
+    f.notes_empty = notes.empty();
+    if (f.notes && notes.StartsWith("regex:"))
+    {
+        f.notes_pattern = new wxRegEx("^(" + notes.Right(notes.length() - 6).ToStdString() + ")$", wxRE_ICASE | wxRE_EXTENDED);
+        if (!f.notes_pattern->IsValid())
+            f.notes_pattern = nullptr;
+    }
+    else if (f.notes && !f.notes_empty)
+        f.notes_pattern = mmCompileWildcard(notes);
+
+    f.tags = mmIsTagsChecked();
+    if (f.tags)
+    {
+        f.tag_strings = tagTextCtrl_->GetTagStrings();
+        f.tagnames = Model_Taglink::instance().get_names_all();
+        mmMergeSplitTags<Model_Splittransaction>(f, Model_Checking::refTypeName);
+        mmMergeSplitTags<Model_Budgetsplittransaction>(f, Model_Billsdeposits::refTypeName);
+    }
+
+    m_compiled = std::move(f);
+    m_compiled_valid = true;
+}
+
+/** Case insensitive regex matching the same strings as wxString::Matches(pattern) */
+wxSharedPtr<wxRegEx> mmFilterTransactionsDialog::mmCompileWildcard(const wxString& pattern)
 {
-    const wxString value = mmGetNotes();
-    if (!value.empty())
+    wxString regex = "^";
+    for (const auto& c : pattern)
     {
-        if (value.StartsWith("regex:"))
+        if (c == '*')
+            regex += ".*";
+        else if (c == '?')
+            regex += ".";
+        else
         {
-            wxRegEx pattern("^(" + value.Right(value.length() - 6).ToStdString() + ")$", wxRE_ICASE | wxRE_EXTENDED);
-            return (pattern.IsValid() && pattern.Matches(note));
+            if (wxString("\\^$.|+()[]{}").Find(c) != wxNOT_FOUND)
+                regex += "\\";
+            regex += c;
         }
-        else
-            return note.Lower().Matches(value.Lower());
     }
-    else
-        return note.IsEmpty();
+    regex += "$";
+    return wxSharedPtr<wxRegEx>(new wxRegEx(regex, wxRE_ICASE | wxRE_EXTENDED));
 }
 
-bool mmFilterTransactionsDialog::mmIsCategoryMatches(int64 categid)
+bool mmFilterTransactionsDialog::mmIsPayeeMatches(int64 payeeID) const
 {
-    return std::find(m_selected_categories_id.begin(), m_selected_categories_id.end(), categid) != m_selected_categories_id.end();
+    return m_compiled.payee_ids.find(payeeID) != m_compiled.payee_ids.end();
 }
 
-bool mmFilterTransactionsDialog::mmIsTagMatches(const wxString& refType, int64 refId, bool mergeSplitTags)
+bool mmFilterTransactionsDialog::mmIsNoteMatches(const wxString& note) const
 {
-    std::map<wxString, int64> tagnames = Model_Taglink::instance().get(refType, refId);
-
-    // If we have a split, merge the transaciton tags so that an AND condition captures cases
-    // where one tag is on the base txn and the other is on the split
-    std::map<wxString, int64> txnTagnames;
-    if (refType == Model_Splittransaction::refTypeName)
-        txnTagnames = Model_Taglink::instance().get(Model_Checking::refTypeName,
-                                                    Model_Splittransaction::instance().get(refId)->TRANSID);
-    else if (refType == Model_Budgetsplittransaction::refTypeName)
-        txnTagnames = Model_Taglink::instance().get(Model_Billsdeposits::refTypeName,
-                                                    Model_Budgetsplittransaction::instance().get(refId)->TRANSID);
-
-    if (mergeSplitTags)
-    {
-        // Merge transaction tags and split tags. This is necessary when checking
-        // if a split record matches the filter since we are using mmIsRecordMatches
-        // to validate the split which gives it the wrong refType & refId
-        if (refType == Model_Checking::refTypeName)
-        {
-            // Loop through checking splits and merge tags for each SPLITTRANSID
-            for (const auto& split : Model_Splittransaction::instance().find(Model_Splittransaction::TRANSID(refId)))
-            {
-                std::map<wxString, int64> splitTagnames =
-                    Model_Taglink::instance().get(Model_Splittransaction::refTypeName, split.SPLITTRANSID);
-                txnTagnames.insert(splitTagnames.begin(), splitTagnames.end());
-            }
-        }
-        else if (refType == Model_Billsdeposits::refTypeName)
-        {
-            // Loop through scheduled txn splits and merge tags for each SPLITTRANSID
-            for (const auto& split : Model_Budgetsplittransaction::instance().find(Model_Budgetsplittransaction::TRANSID(refId)))
-            {
-                std::map<wxString, int64> splitTagnames =
-                    Model_Taglink::instance().get(Model_Budgetsplittransaction::refTypeName, split.SPLITTRANSID);
-                txnTagnames.insert(splitTagnames.begin(), splitTagnames.end());
-            }
-        }
-    }
+    if (m_compiled.notes_empty)
+        return note.IsEmpty();
+    return m_compiled.notes_pattern && m_compiled.notes_pattern->Matches(note);
+}
 
-    tagnames.insert(txnTagnames.begin(), txnTagnames.end());
-    if (tagnames.empty())
+bool mmFilterTransactionsDialog::mmIsCategoryMatches(int64 categid) const
+{
+    return m_compiled.category_ids.find(categid) != m_compiled.category_ids.end();
+}
+
+bool mmFilterTransactionsDialog::mmIsTagMatches(const wxString& refType, int64 refId, bool mergeSplitTags) const
+{
+    // Split tags are merged with the transaction tags so that an AND condition captures cases
+    // where one tag is on the base txn and the other is on the split. With mergeSplitTags,
+    // a transaction also gets the tags of all its splits. This is necessary when checking
+    // if a split record matches the filter since we are using mmIsRecordMatches
+    // to validate the split which gives it the wrong refType & refId
+    const auto& index = (mergeSplitTags &&
+        (refType == Model_Checking::refTypeName || refType == Model_Billsdeposits::refTypeName)
+    ) ? m_compiled.merged_tagnames : m_compiled.tagnames;
+
+    const auto ref_tags = index.find(refType);
+    if (ref_tags == index.end())
+        return false;
+    const auto it = ref_tags->second.find(refId);
+    if (it == ref_tags->second.end() || it->second.empty())
         return false;
+    const std::set<wxString>& tagnames = it->second;
 
     bool match = true;
 
-    wxArrayString tags = tagTextCtrl_->GetTagStrings();
+    const wxArrayString& tags = m_compiled.tag_strings;
     for (int i = 0; i < static_cast<int>(tags.GetCount()); i++)
     {
         wxString tag = tags.Item(i);
@@ -1433,33 +1494,37 @@ template <class MODEL, class DATA> bool mmFilterTransactionsDialog::mmIsRecordMa
 {
     bool ok = true;
 
+    if (!m_compiled_valid)
+        mmCompileFilter();
+    const Compiled& f = m_compiled;
+
     // wxLogDebug("Check date? %i trx date:%s %s %s", getDateRangeCheckBox(), tran.TRANSDATE, getFromDateCtrl().GetDateOnly().FormatISODate(),
-    if (mmIsAccountChecked() && std::find(m_selected_accounts_id.begin(), m_selected_accounts_id.end(), tran.ACCOUNTID) == m_selected_accounts_id.end() && std::find(m_selected_accounts_id.begin(), m_selected_accounts_id.end(), tran.TOACCOUNTID) == m_selected_accounts_id.end())
+    if (f.account && f.account_ids.find(tran.ACCOUNTID) == f.account_ids.end() && f.account_ids.find(tran.TOACCOUNTID) == f.account_ids.end())
         ok = false;
-    else if ((mmIsDateRangeChecked() || mmIsRangeChecked()) && (tran.TRANSDATE < m_begin_date.Mid(0, tran.TRANSDATE.length()) || tran.TRANSDATE > m_end_date.Mid(0, tran.TRANSDATE.length())))
+    else if (f.dates && (tran.TRANSDATE < m_begin_date.Mid(0, tran.TRANSDATE.length()) || tran.TRANSDATE > m_end_date.Mid(0, tran.TRANSDATE.length())))
         ok = false;
-    else if (mmIsPayeeChecked() && !mmIsPayeeMatches(tran.PAYEEID))
+    else if (f.payee && !mmIsPayeeMatches(tran.PAYEEID))
         ok = false;
-    else if (mmIsCategoryChecked() && !mmIsCategoryMatches(tran.CATEGID))
+    else if (f.category && !mmIsCategoryMatches(tran.CATEGID))
         ok = false;
-    else if (mmIsStatusChecked() && !mmIsStatusMatches(tran.STATUS))
+    else if (f.status && !mmIsStatusMatches(tran.STATUS))
         ok = false;
     else if (mmIsTypeChecked() && !mmIsTypeMaches(tran.TRANSCODE, tran.ACCOUNTID, tran.TOACCOUNTID))
         ok = false;
-    else if (mmIsAmountRangeMinChecked() && mmGetAmountMin() > tran.TRANSAMOUNT)
+    else if (f.amount_min && f.amount_min_value > tran.TRANSAMOUNT)
         ok = false;
-    else if (mmIsAmountRangeMaxChecked() && mmGetAmountMax() < tran.TRANSAMOUNT)
+    else if (f.amount_max && f.amount_max_value < tran.TRANSAMOUNT)
         ok = false;
-    else if (mmIsNumberChecked() && (mmGetNumber().empty() ? !tran.TRANSACTIONNUMBER.empty()
-                                                           : tran.TRANSACTIONNUMBER.empty() || !tran.TRANSACTIONNUMBER.Lower().Matches(mmGetNumber().Lower())))
+    else if (f.number && (f.number_empty ? !tran.TRANSACTIONNUMBER.empty()
+                                         : tran.TRANSACTIONNUMBER.empty() || !f.number_pattern->Matches(tran.TRANSACTIONNUMBER)))
         ok = false;
-    else if (mmIsNotesChecked() && !mmIsNoteMatches(tran.NOTES))
+    else if (f.notes && !mmIsNoteMatches(tran.NOTES))
         ok = false;
     else if (mmIsColorChecked() && (m_color_value != tran.COLOR))
         ok = false;
     else if (mmIsCustomFieldChecked() && !mmIsCustomFieldMatches(tran.id()))
         ok = false;
-    else if (mmIsTagsChecked())
+    else if (f.tags)
     {
         wxString refType;
         // Check the Data type to determine the tag RefType
@@ -1486,7 +1551,9 @@ template <class MODEL, class DATA> bool mmFilterTransactionsDialog::mmIsSplitRec
         refType = Model_Budgetsplittransaction::refTypeName;
     }
 
-    if (mmIsTagsChecked() && !mmIsTagMatches(refType, split.SPLITTRANSID))
+    if (!m_compiled_valid)
+        mmCompileFilter();
+    if (m_compiled.tags && !mmIsTagMatches(refType, split.SPLITTRANSID))
         return false;
 
     return true;
@@ -2004,6 +2071,7 @@ const wxString mmFilterTransactionsDialog::mmGetJsonSettings(bool i18n) const
 
 void mmFilterTransactionsDialog::OnCategoryChange(wxEvent& event)
 {
+    m_compiled_valid = false;
     m_selected_categories_id.clear();
     if (!categoryComboBox_->GetValue().IsEmpty())
     {
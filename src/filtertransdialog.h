@@ -30,6 +30,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "reports/htmlbuilder.h"
 
 #include <wx/dialog.h>
+#include <wx/regex.h>
+#include <unordered_set>
 #include "mmTextCtrl.h"
 
 
@@ -120,6 +122,7 @@ public:
     bool mmIsFutureIgnored() const;
     const wxString mmGetJsonSettings(bool i18n = false) const;
     const wxString mmGetLabelString() const;
+    void mmCompileFilter();
 
 private:
     const wxString mmGetTypes() const;
@@ -130,10 +133,14 @@ private:
     double mmGetAmountMax() const;
     double mmGetAmountMin() const;
 
-    bool mmIsPayeeMatches(int64 payeeid);
-    bool mmIsCategoryMatches(int64 categid);
-    bool mmIsNoteMatches(const wxString& note);
-    bool mmIsTagMatches(const wxString& refType, int64 refId, bool mergeSplitTags = false);
+    bool mmIsPayeeMatches(int64 payeeid) const;
+    bool mmIsCategoryMatches(int64 categid) const;
+    bool mmIsNoteMatches(const wxString& note) const;
+    static wxSharedPtr<wxRegEx> mmCompileWildcard(const wxString& pattern);
+    struct Compiled;
+    template <class SPLIT_MODEL>
+    static void mmMergeSplitTags(Compiled& f, const wxString& tranRefType);
+    bool mmIsTagMatches(const wxString& refType, int64 refId, bool mergeSplitTags = false) const;
 
     void setTransferTypeCheckBoxes();
 
@@ -257,6 +264,30 @@ private:
     wxArrayInt64 m_selected_categories_id;
     wxSharedPtr<mmCustomData> m_custom_fields;
 
+    /* Filter values compiled from the controls by mmCompileFilter(),
+       so that matching a record does not read controls or compile patterns */
+    struct Compiled
+    {
+        bool account = false, dates = false, payee = false, category = false, status = false;
+        bool amount_min = false, amount_max = false, number = false, notes = false;
+        std::unordered_set<int64> account_ids;
+        std::unordered_set<int64> payee_ids;
+        std::unordered_set<int64> category_ids;
+        wxString status_key;
+        double amount_min_value = 0.0, amount_max_value = 0.0;
+        bool number_empty = false, notes_empty = false;
+        wxSharedPtr<wxRegEx> number_pattern;
+        wxSharedPtr<wxRegEx> notes_pattern;     // nullptr if the regex is invalid
+        bool tags = false;
+        wxArrayString tag_strings;
+        // tag names by REFTYPE and REFID; split tags include the tags of their transaction
+        std::map<wxString, std::unordered_map<int64, std::set<wxString> > > tagnames;
+        // transaction tags merged with the tags of their splits, by REFTYPE and REFID
+        std::map<wxString, std::unordered_map<int64, std::set<wxString> > > merged_tagnames;
+    };
+    Compiled m_compiled;
+    bool m_compiled_valid = false;
+
     enum
     {
         /* Filter Dialog */
@@ -30,6 +30,70 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "model/Model_CustomFieldData.h"
 #include "model/Model_CustomField.h"
 #include "model/Model_Tag.h"
+#include "model/Model_Taglink.h"
+
+mmExportStream::mmExportStream(wxTextCtrl* log, const wxString& file_name)
+    : log_(log)
+{
+    if (file_name.IsEmpty())
+        return;
+
+    file_ = std::make_unique<wxFileOutputStream>(file_name);
+    if (!file_->IsOk())
+        return;
+    buffered_ = std::make_unique<wxBufferedOutputStream>(*file_);
+    text_ = std::make_unique<wxTextOutputStream>(*buffered_);
+}
+
+mmExportStream::~mmExportStream()
+{
+    Close();
+}
+
+void mmExportStream::Close()
+{
+    Flush();
+    text_.reset();
+    if (buffered_)
+        buffered_->Close();
+    buffered_.reset();
+    if (file_)
+        file_->Close();
+    file_.reset();
+    log_ = nullptr;
+}
+
+bool mmExportStream::IsOk() const
+{
+    return file_ ? text_ != nullptr : log_ != nullptr;
+}
+
+mmExportStream& mmExportStream::operator<<(const wxString& text)
+{
+    pending_ << text;
+    if (pending_.length() >= CHUNK)
+        Flush();
+    return *this;
+}
+
+void mmExportStream::Write(StringBuffer& json, bool all)
+{
+    if (!all && json.GetSize() < CHUNK)
+        return;
+    *this << wxString::FromUTF8(json.GetString(), json.GetSize());
+    json.Clear();
+}
+
+void mmExportStream::Flush()
+{
+    if (pending_.IsEmpty())
+        return;
+    if (text_)
+        *text_ << pending_;
+    else if (log_)
+        log_->AppendText(pending_);
+    pending_.clear();
+}
 
 mmExportTransaction::mmExportTransaction()
 {}
@@ -37,6 +101,12 @@ mmExportTransaction::mmExportTransaction()
 mmExportTransaction::~mmExportTransaction()
 {}
 
+mmExportTransaction::Links::Links()
+    : attachments(Model_Attachment::instance().get_all(Model_Checking::refTypeName))
+    , field_data(Model_CustomFieldData::instance().get_all(Model_Checking::refTypeName))
+    , split_tags(Model_Taglink::instance().get_all(Model_Splittransaction::refTypeName))
+{}
+
 const wxString mmExportTransaction::getTransactionCSV(const Model_Checking::Full_Data& full_tran
     , const wxString& dateMask, bool reverce)
 {
@@ -406,7 +476,8 @@ void mmExportTransaction::getUsedCategoriesJSON(PrettyWriter<StringBuffer>& json
     json_writer.EndArray();
 }
 
-void mmExportTransaction::getTransactionJSON(PrettyWriter<StringBuffer>& json_writer, const Model_Checking::Full_Data& full_tran)
+void mmExportTransaction::getTransactionJSON(PrettyWriter<StringBuffer>& json_writer, const Model_Checking::Full_Data& full_tran
+    , const Links& links)
 {
     json_writer.StartObject();
     full_tran.as_json(json_writer);
@@ -434,8 +505,11 @@ void mmExportTransaction::getTransactionJSON(PrettyWriter<StringBuffer>& json_wr
             json_writer.Double(valueSplit);
             json_writer.Key("TAGS");
             json_writer.StartArray();
-            for (const auto& tag : Model_Taglink::instance().get(Model_Splittransaction::refTypeName, split_entry.SPLITTRANSID))
-                json_writer.Int64(tag.second.GetValue());
+            const auto tags = links.split_tags.find(split_entry.SPLITTRANSID);
+            if (tags != links.split_tags.end()) {
+                for (const auto& tag : tags->second)
+                    json_writer.Int64(tag.TAGID.GetValue());
+            }
             json_writer.EndArray();
             json_writer.EndObject();
 
@@ -443,36 +517,25 @@ void mmExportTransaction::getTransactionJSON(PrettyWriter<StringBuffer>& json_wr
         json_writer.EndArray();
     }
 
-    const wxString RefType = Model_Checking::refTypeName;
-    Model_Attachment::Data_Set attachments = Model_Attachment::instance().FilterAttachments(RefType, full_tran.id());
-
-    if (!attachments.empty())
+    const auto attachments = links.attachments.find(full_tran.id());
+    if (attachments != links.attachments.end())
     {
-        const wxString folder = Model_Infotable::instance().getString("ATTACHMENTSFOLDER:" + mmPlatformType(), "");
         json_writer.Key("ATTACHMENTS");
         json_writer.StartArray();
-        for (const auto &entry : attachments) {
+        for (const auto &entry : attachments->second) {
             json_writer.Int64(entry.ATTACHMENTID.GetValue());
         }
         json_writer.EndArray();
     }
 
-    auto data = Model_CustomFieldData::instance().find(Model_CustomFieldData::REFID(full_tran.id()));
-    auto f = Model_CustomField::instance().find(Model_CustomField::REFTYPE(RefType));
-    if (!data.empty())
+    // only data of the custom fields of transactions is loaded
+    const auto data = links.field_data.find(full_tran.id());
+    if (data != links.field_data.end())
     {
         json_writer.Key("CUSTOM_FIELDS");
         json_writer.StartArray();
-        for (const auto &entry : data)
-        {
-
-            auto customFields = Model_CustomField::instance().find(
-                Model_CustomField::REFTYPE(RefType)
-                , Model_CustomField::FIELDID(entry.FIELDID));
-
-            for (const auto& i : customFields) {
-                json_writer.Int64(i.FIELDID.GetValue());
-            }
+        for (const auto &entry : data->second) {
+            json_writer.Int64(entry.FIELDID.GetValue());
         }
         json_writer.EndArray();
     }
@@ -480,7 +543,7 @@ void mmExportTransaction::getTransactionJSON(PrettyWriter<StringBuffer>& json_wr
     json_writer.EndObject();
 }
 
-void mmExportTransaction::getAttachmentsJSON(PrettyWriter<StringBuffer>& json_writer, wxArrayInt64& allAttachment4Export)
+void mmExportTransaction::getAttachmentsJSON(PrettyWriter<StringBuffer>& json_writer, const Id_Set& allAttachment4Export)
 {
 
     if (!allAttachment4Export.empty())
@@ -506,7 +569,7 @@ void mmExportTransaction::getAttachmentsJSON(PrettyWriter<StringBuffer>& json_wr
         for (const auto& entry : attachments)
         {
             if (entry.REFTYPE != RefType) continue;
-            if (std::find(allAttachment4Export.begin(), allAttachment4Export.end(), entry.REFID) == allAttachment4Export.end()) continue;
+            if (allAttachment4Export.count(entry.REFID) == 0) continue;
 
             json_writer.StartObject();
             entry.as_json(json_writer);
@@ -517,7 +580,7 @@ void mmExportTransaction::getAttachmentsJSON(PrettyWriter<StringBuffer>& json_wr
     }
 }
 
-void mmExportTransaction::getCustomFieldsJSON(PrettyWriter<StringBuffer>& json_writer, wxArrayInt64& allCustomFields4Export)
+void mmExportTransaction::getCustomFieldsJSON(PrettyWriter<StringBuffer>& json_writer, const Id_Set& allCustomFields4Export)
 {
 
     if (!allCustomFields4Export.empty())
@@ -528,7 +591,7 @@ void mmExportTransaction::getCustomFieldsJSON(PrettyWriter<StringBuffer>& json_w
         json_writer.StartObject();
 
         // Data
-        wxArrayInt64 cd;
+        Id_Set cd;
         Model_CustomFieldData::Data_Set cds = Model_CustomFieldData::instance().all();
 
         if (!cds.empty()) {
@@ -537,12 +600,9 @@ void mmExportTransaction::getCustomFieldsJSON(PrettyWriter<StringBuffer>& json_w
 
             for (const auto& entry : cds)
             {
-                if (std::find(allCustomFields4Export.begin(), allCustomFields4Export.end(), entry.FIELDATADID) != allCustomFields4Export.end())
+                if (allCustomFields4Export.count(entry.FIELDATADID) > 0)
                 {
-                    if (std::find(cd.begin(), cd.end(), entry.FIELDID) == cd.end())
-                    {
-                        cd.push_back(entry.FIELDID);
-                    }
+                    cd.insert(entry.FIELDID);
                     json_writer.StartObject();
                     entry.as_json(json_writer);
                     json_writer.EndObject();
@@ -562,7 +622,7 @@ void mmExportTransaction::getCustomFieldsJSON(PrettyWriter<StringBuffer>& json_w
 
             for (const auto& entry : custom_fields)
             {
-                if (std::find(cd.begin(), cd.end(), entry.FIELDID) == cd.end())
+                if (cd.count(entry.FIELDID) == 0)
                     continue;
 
                 json_writer.StartObject();
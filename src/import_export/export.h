@@ -19,7 +19,40 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #ifndef MM_EX_EXPORT_H_
 #define MM_EX_EXPORT_H_
 
+#include <memory>
+#include <unordered_set>
+#include <wx/textctrl.h>
+#include <wx/txtstrm.h>
+#include <wx/wfstream.h>
 #include "model/Model_Checking.h"
+#include "model/Model_Attachment.h"
+#include "model/Model_CustomFieldData.h"
+
+// Destination of an export, a file or the log control. Text is handed on in
+// chunks, so the output of a large export is never held in memory at once.
+class mmExportStream
+{
+public:
+    /** Write to the file when file_name is not empty, otherwise to the log */
+    mmExportStream(wxTextCtrl* log, const wxString& file_name);
+    ~mmExportStream();
+
+    bool IsOk() const;
+    mmExportStream& operator<<(const wxString& text);
+    /** Move the JSON written so far to the stream once it fills a chunk, or always if all */
+    void Write(StringBuffer& json, bool all = false);
+    void Flush();
+    /** Flush and close the file, nothing can be written afterwards */
+    void Close();
+
+private:
+    static const size_t CHUNK = 64 * 1024;
+    wxTextCtrl* log_;
+    std::unique_ptr<wxFileOutputStream> file_;
+    std::unique_ptr<wxBufferedOutputStream> buffered_;
+    std::unique_ptr<wxTextOutputStream> text_;
+    wxString pending_;
+};
 
 class mmExportTransaction
 {
@@ -28,6 +61,17 @@ public:
     virtual ~mmExportTransaction();
     mmExportTransaction();
 
+    typedef std::unordered_set<int64, DB_Id_Hash> Id_Set;
+
+    /** Attachments, custom field data and split tags of the transactions, loaded once per export */
+    struct Links
+    {
+        Links();
+        std::map<int64, Model_Attachment::Data_Set> attachments;
+        std::map<int64, Model_CustomFieldData::Data_Set> field_data;
+        std::map<int64, Model_Taglink::Data_Set> split_tags;
+    };
+
     static const wxString getTransactionQIF(const Model_Checking::Full_Data & tran, const wxString& dateMask, bool reverce = false);
     static const wxString getTransactionCSV(const Model_Checking::Full_Data & tran, const wxString& dateMask, bool reverce = false);
     static const wxString getAccountHeaderQIF(int64 accountID);
@@ -36,13 +80,13 @@ public:
     static const wxString qif_acc_type(const wxString& mmex_type);
     static const wxString mm_acc_type(const wxString& qif_type);
 
-    static void getTransactionJSON(PrettyWriter<StringBuffer>& json_writer, const Model_Checking::Full_Data & tran);
+    static void getTransactionJSON(PrettyWriter<StringBuffer>& json_writer, const Model_Checking::Full_Data & tran, const Links& links);
     static void getCategoriesJSON(PrettyWriter<StringBuffer>& json_writer);
     static void getUsedCategoriesJSON(PrettyWriter<StringBuffer>& json_writer);
     static void getAccountsJSON(PrettyWriter<StringBuffer>& json_writer, std::map <int64 /*account ID*/, wxString>& allAccounts4Export);
     static void getPayeesJSON(PrettyWriter<StringBuffer>& json_writer, wxArrayInt64& allPayeess4Export);
-    static void getAttachmentsJSON(PrettyWriter<StringBuffer>& json_writer, wxArrayInt64& allAttachment4Export);
-    static void getCustomFieldsJSON(PrettyWriter<StringBuffer>& json_writer, wxArrayInt64& allCustomFields4Export);
+    static void getAttachmentsJSON(PrettyWriter<StringBuffer>& json_writer, const Id_Set& allAttachment4Export);
+    static void getCustomFieldsJSON(PrettyWriter<StringBuffer>& json_writer, const Id_Set& allCustomFields4Export);
     static void getTagsJSON(PrettyWriter<StringBuffer>& json_writer, wxArrayInt64& allTags4Export);
 };
 
@@ -0,0 +1,246 @@
+/*******************************************************
+Copyright (C) 2026 The Money Manager Ex developers
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+********************************************************/
+
+#include "import_engine.h"
+#include <cmath>
+#include <limits>
+#include <wx/tokenzr.h>
+#include "model/Model_Category.h"
+#include "model/Model_Currency.h"
+#include "model/Model_CustomFieldData.h"
+#include "model/Model_Payee.h"
+#include "model/Model_Tag.h"
+#include "model/Model_Taglink.h"
+
+mmImportEngine::mmImportEngine(size_t batch_size, bool read_only)
+    : batch_size_(batch_size > 0 ? batch_size : 1), read_only_(read_only)
+{
+    // names are COLLATE NOCASE in the database
+    for (const auto& payee : Model_Payee::instance().all())
+        payees_[payee.PAYEENAME.Lower()] = payee.PAYEEID;
+    for (const auto& category : Model_Category::instance().all())
+        categories_[std::make_pair(category.PARENTID, category.CATEGNAME.Lower())] = category.CATEGID;
+    for (const auto& tag : Model_Tag::instance().all())
+        tags_[tag.TAGNAME.Lower()] = tag.TAGID;
+    for (const auto& account : Model_Account::instance().all())
+    {
+        account_ids_[account.ACCOUNTNAME.Lower()] = account.ACCOUNTID;
+        accounts_[account.ACCOUNTID] = Model_Account::instance().get(account.ACCOUNTID);
+    }
+
+    pending_.reserve(batch_size_);
+}
+
+int64 mmImportEngine::getPayeeID(const wxString& name, bool create)
+{
+    const auto it = payees_.find(name.Lower());
+    if (it != payees_.end())
+        return it->second;
+    if (!create || read_only_)
+        return -1;
+
+    Model_Payee::Data* payee = Model_Payee::instance().create();
+    payee->PAYEENAME = name;
+    payee->ACTIVE = 1;
+    payee->CATEGID = -1;
+    const int64 payee_id = Model_Payee::instance().save(payee);
+    payees_[name.Lower()] = payee_id;
+    return payee_id;
+}
+
+int64 mmImportEngine::getCategoryID(const wxString& path, int64 parent_id, bool create)
+{
+    int64 category_id = parent_id;
+    wxStringTokenizer tokenizer(path, ":");
+    while (tokenizer.HasMoreTokens())
+    {
+        const wxString name = tokenizer.GetNextToken().Trim().Trim(false);
+        const auto key = std::make_pair(category_id, name.Lower());
+        const auto it = categories_.find(key);
+        if (it != categories_.end())
+        {
+            category_id = it->second;
+            continue;
+        }
+        if (!create || read_only_)
+            return -1;
+
+        Model_Category::Data* category = Model_Category::instance().create();
+        category->CATEGNAME = name;
+        category->PARENTID = category_id;
+        category->ACTIVE = 1;
+        category_id = Model_Category::instance().save(category);
+        categories_[key] = category_id;
+    }
+    return category_id;
+}
+
+int64 mmImportEngine::getTagID(const wxString& name, bool create)
+{
+    const auto it = tags_.find(name.Lower());
+    if (it != tags_.end())
+        return it->second;
+    if (!create || read_only_)
+        return -1;
+
+    Model_Tag::Data* tag = Model_Tag::instance().create();
+    tag->TAGNAME = name;
+    tag->ACTIVE = 1;
+    const int64 tag_id = Model_Tag::instance().save(tag);
+    tags_[name.Lower()] = tag_id;
+    return tag_id;
+}
+
+int64 mmImportEngine::getAccountID(const wxString& name) const
+{
+    const auto it = account_ids_.find(name.Lower());
+    return it != account_ids_.end() ? it->second : -1;
+}
+
+Model_Account::Data* mmImportEngine::getAccount(int64 account_id) const
+{
+    const auto it = accounts_.find(account_id);
+    return it != accounts_.end() ? it->second : nullptr;
+}
+
+void mmImportEngine::append(Model_Checking::Data* trx, const wxArrayInt64& tags
+    , const std::map<int, wxString>& custom_fields)
+{
+    pending_.push_back({ trx, tags, custom_fields });
+    if (pending_.size() >= batch_size_)
+        flush();
+}
+
+void mmImportEngine::flush()
+{
+    if (pending_.empty())
+        return;
+
+    const wxString& reftype = Model_Checking::refTypeName;
+    Model_Taglink::Cache taglinks;
+    Model_CustomFieldData::Cache field_data;
+
+    Model_Checking::instance().Savepoint("IMP_BATCH");
+    for (const auto& item : pending_)
+    {
+        const int64 transid = Model_Checking::instance().save(item.trx);
+        for (const auto& tag_id : item.tags)
+        {
+            Model_Taglink::Data* taglink = Model_Taglink::instance().create();
+            taglink->REFTYPE = reftype;
+            taglink->REFID = transid;
+            taglink->TAGID = tag_id;
+            taglinks.push_back(taglink);
+        }
+        for (const auto& field : item.custom_fields)
+        {
+            Model_CustomFieldData::Data* data = Model_CustomFieldData::instance().create();
+            data->FIELDID = field.first;
+            data->REFID = transid;
+            data->CONTENT = field.second;
+            field_data.push_back(data);
+        }
+    }
+    if (!taglinks.empty())
+        Model_Taglink::instance().save(taglinks);
+    if (!field_data.empty())
+        Model_CustomFieldData::instance().save(field_data);
+    Model_Checking::instance().ReleaseSavepoint("IMP_BATCH");
+
+    saved_ += pending_.size();
+    pending_.clear();
+}
+
+bool mmImportEngine::is_progress_due()
+{
+    const long now = timer_.Time();
+    if (last_progress_ >= 0 && now - last_progress_ < 100)
+        return false;
+    last_progress_ = now;
+    return true;
+}
+
+const wxString mmImportEngine::throughput(size_t rows) const
+{
+    const double seconds = timer_.Time() / 1000.0;
+    return wxString::Format(_t("Processed %1$zu rows in %2$.1f s (%3$.0f rows/s)")
+        , rows, seconds, seconds > 0 ? rows / seconds : 0.0);
+}
+
+void mmImportEngine::setDuplicateWindow(int first_day, int last_day)
+{
+    window_ = true;
+    first_day_ = first_day;
+    last_day_ = last_day;
+    exact_.clear();
+    fuzzy_.clear();
+    scales_.clear();
+}
+
+mmImportEngine::DUPLICATE_ID mmImportEngine::duplicate(int64 account_id, int day, double flow, int64 payee_id)
+{
+    if (scales_.find(account_id) == scales_.end())
+        index(account_id);
+
+    const int64 amount = minor_units(account_id, flow);
+    if (exact_.count({ account_id, amount, payee_id, day }) > 0)
+        return DUPLICATE_EXACT;
+    for (int d = day - DUPLICATE_DAYS; d <= day + DUPLICATE_DAYS; d++)
+    {
+        if (fuzzy_.count({ account_id, amount, FUZZY_PAYEE, d }) > 0)
+            return DUPLICATE_FUZZY;
+    }
+    return DUPLICATE_NONE;
+}
+
+void mmImportEngine::index(int64 account_id)
+{
+    const Model_Account::Data* account = getAccount(account_id);
+    const Model_Currency::Data* currency = account ? Model_Account::currency(account) : nullptr;
+    scales_[account_id] = currency && currency->SCALE > 0 ? static_cast<double>(currency->SCALE.GetValue()) : 100.0;
+
+    const auto& columns = Model_Checking::instance().columns();
+    const auto rows = window_
+        ? columns.range(first_day_ - DUPLICATE_DAYS, last_day_ + DUPLICATE_DAYS)
+        : columns.range(std::numeric_limits<int>::min(), std::numeric_limits<int>::max());
+    for (size_t i = rows.first; i < rows.second; i++)
+    {
+        if (columns.ACCOUNTID[i] != account_id && columns.TOACCOUNTID[i] != account_id)
+            continue;
+        const double flow = columns.account_flow(i, account_id);
+        if (flow == 0.0)
+            continue;
+
+        const int64 amount = minor_units(account_id, flow);
+        exact_.insert({ account_id, amount, columns.PAYEEID[i], columns.DAY[i] });
+        fuzzy_.insert({ account_id, amount, FUZZY_PAYEE, columns.DAY[i] });
+    }
+}
+
+int64 mmImportEngine::minor_units(int64 account_id, double amount)
+{
+    return std::llround(amount * scales_[account_id]);
+}
+
+size_t mmImportEngine::DuplicateKeyHash::operator()(const DuplicateKey& key) const
+{
+    size_t h = std::hash<int64>()(key.account_id);
+    h = h * 31 + std::hash<int64>()(key.amount);
+    h = h * 31 + std::hash<int64>()(key.payee_id);
+    return h * 31 + std::hash<int>()(key.day);
+}
@@ -0,0 +1,132 @@
+/*******************************************************
+Copyright (C) 2026 The Money Manager Ex developers
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+********************************************************/
+
+#ifndef MM_EX_IMPORT_ENGINE_H_
+#define MM_EX_IMPORT_ENGINE_H_
+
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <wx/stopwatch.h>
+#include "model/Model_Account.h"
+#include "model/Model_Checking.h"
+
+// Shared by the CSV and QIF importers.
+// Payees, categories, tags and accounts are loaded into name -> id maps once
+// per import, and new transactions are saved in batches together with their
+// tags and custom field data. Imported rows can be checked against a hash
+// index of the existing transactions to flag duplicates.
+class mmImportEngine
+{
+public:
+    /** A read only engine never creates payees, categories or tags, e.g. for a preview */
+    explicit mmImportEngine(size_t batch_size = 1000, bool read_only = false);
+
+    /** Return the payee id for the name, -1 when missing and create is false */
+    int64 getPayeeID(const wxString& name, bool create = true);
+    /**
+    * Return the category id for a ":" delimited path below parent_id,
+    * -1 when a level is missing and create is false.
+    */
+    int64 getCategoryID(const wxString& path, int64 parent_id = -1, bool create = true);
+    /** Return the tag id for the name, -1 when missing and create is false */
+    int64 getTagID(const wxString& name, bool create = true);
+    int64 getAccountID(const wxString& name) const;
+    Model_Account::Data* getAccount(int64 account_id) const;
+
+    /** Queue a new transaction, the queue is saved once it holds a full batch */
+    void append(Model_Checking::Data* trx, const wxArrayInt64& tags = {}
+        , const std::map<int, wxString>& custom_fields = {});
+    /** Save the queued transactions in one savepoint */
+    void flush();
+    size_t saved() const { return saved_; }
+
+    enum DUPLICATE_ID { DUPLICATE_NONE = 0, DUPLICATE_FUZZY, DUPLICATE_EXACT };
+    static const int DUPLICATE_DAYS = 3;
+    /**
+    * Limit the duplicate index to [first_day, last_day] (ModelBase::to_day),
+    * widened by DUPLICATE_DAYS. Without a window all dates are indexed.
+    */
+    void setDuplicateWindow(int first_day, int last_day);
+    /**
+    * Check a row against the existing transactions of the account, where flow is
+    * the signed amount for the account. Exact when day, amount and payee match,
+    * fuzzy when the amount matches within DUPLICATE_DAYS. The account is indexed
+    * on first use, so rows saved by this engine are not compared with each other.
+    */
+    DUPLICATE_ID duplicate(int64 account_id, int day, double flow, int64 payee_id);
+
+    /** True at most every 100 ms, so progress dialogs are not repainted for every row */
+    bool is_progress_due();
+    /** Rows per second since the engine was created, for the import log */
+    const wxString throughput(size_t rows) const;
+
+private:
+    struct Pending
+    {
+        Model_Checking::Data* trx;
+        wxArrayInt64 tags;
+        std::map<int, wxString> custom_fields;
+    };
+
+    // Amount in the minor units of the account currency, payee_id is FUZZY_PAYEE for the fuzzy set
+    struct DuplicateKey
+    {
+        int64 account_id;
+        int64 amount;
+        int64 payee_id;
+        int day;
+        bool operator==(const DuplicateKey& other) const
+        {
+            return account_id == other.account_id && amount == other.amount
+                && payee_id == other.payee_id && day == other.day;
+        }
+    };
+    struct DuplicateKeyHash
+    {
+        size_t operator()(const DuplicateKey& key) const;
+    };
+    static const int FUZZY_PAYEE = 0;
+
+    void index(int64 account_id);
+    int64 minor_units(int64 account_id, double amount);
+
+    size_t batch_size_;
+    bool read_only_;
+    size_t saved_ = 0;
+    std::vector<Pending> pending_;
+
+    std::unordered_map<wxString, int64> payees_;                // lower case name
+    std::map<std::pair<int64, wxString>, int64> categories_;    // (parent, lower case name)
+    std::unordered_map<wxString, int64> tags_;                  // lower case name
+    std::unordered_map<wxString, int64> account_ids_;           // lower case name
+    std::unordered_map<int64, Model_Account::Data*> accounts_;
+
+    std::unordered_set<DuplicateKey, DuplicateKeyHash> exact_;
+    std::unordered_set<DuplicateKey, DuplicateKeyHash> fuzzy_;
+    std::unordered_map<int64, double> scales_;  // accounts already indexed
+    bool window_ = false;
+    int first_day_ = 0;
+    int last_day_ = 0;
+
+    wxStopWatch timer_;
+    long last_progress_ = -1;
+};
+
+#endif
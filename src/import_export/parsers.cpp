@@ -20,9 +20,9 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "mmSimpleDialogs.h"
 #include "util.h"
 #include <wx/xml/xml.h>
+#include <wx/file.h>
 #include <wx/filename.h>
 #include <wx/textfile.h>
-#include <wx/tokenzr.h>
 
 // ---------------------------- CSV Parser --------------------------------
 FileCSV::FileCSV(wxWindow *pParentWindow, wxConvAuto encoding, wxString delimiter):
@@ -39,49 +39,222 @@ bool FileCSV::Load(const wxString& fileName, unsigned int itemsInLine)
         return false;
     }
 
-    // Open file
-    wxTextFile txtFile(fileName);
-    if (!txtFile.Open(encoding_))
+    // Read the whole file in one block
+    wxFile file(fileName);
+    const wxFileOffset length = file.IsOpened() ? file.Length() : wxInvalidOffset;
+    if (length == wxInvalidOffset)
     {
         mmErrorDialogs::MessageError(pParentWindow_, _t("Unable to open file."), _t("Universal CSV Import"));
         return false;
     }
+    buffer_.resize(static_cast<size_t>(length));
+    if (length > 0 && file.Read(&buffer_[0], buffer_.size()) != static_cast<ssize_t>(buffer_.size()))
+    {
+        mmErrorDialogs::MessageError(pParentWindow_, _t("Unable to open file."), _t("Universal CSV Import"));
+        return false;
+    }
+    file.Close();
+
+    // The scanner works on bytes, which is safe for UTF-8 and the single byte
+    // code pages. Files marked as UTF-16/32 are transcoded to UTF-8 first.
+    utf8_ = false;
+    if (buffer_.compare(0, 3, "\xEF\xBB\xBF") == 0)
+    {
+        buffer_.erase(0, 3);
+        utf8_ = true;
+    }
+    else if (buffer_.compare(0, 2, "\xFF\xFE") == 0 || buffer_.compare(0, 2, "\xFE\xFF") == 0
+        || buffer_.compare(0, 4, std::string("\0\0\xFE\xFF", 4)) == 0)
+    {
+        const wxScopedCharBuffer text = wxString(buffer_.data(), wxConvAuto(), buffer_.size()).ToUTF8();
+        buffer_.assign(text.data(), text.length());
+        utf8_ = true;
+    }
+
+    Index(itemsInLine);
+    return true;
+}
 
-    // Parse rows
-    wxString line;
-    int row = 0;
-    wxRegEx splitLinePattern(delimiter_ + "[\x1a]?\"[^\"]*?$");
-    for (line = txtFile.GetFirstLine(); !txtFile.Eof(); line = txtFile.GetNextLine())
+void FileCSV::Index(unsigned int itemsInLine)
+{
+    std::string delimiter = utf8_ ? std::string(delimiter_.ToUTF8()) : std::string(delimiter_.mb_str(encoding_));
+    if (delimiter.empty())
+        delimiter = ",";
+    const char d0 = delimiter[0];
+    const size_t dlen = delimiter.length();
+    const char* data = buffer_.data();
+    const size_t size = buffer_.size();
+
+    fields_.clear();
+    rows_.clear();
+    rows_.push_back(0);
+
+    // QUOTE: a quote was seen inside a quoted field, it either closes the field or starts a "" pair
+    enum { FIELD_START, UNQUOTED, QUOTED, QUOTE } state = FIELD_START;
+    size_t begin = 0;
+    bool escaped = false;
+    unsigned int items = 0;
+
+    const auto add_field = [&](size_t from, size_t to, bool esc)
+    {
+        if (items++ < itemsInLine)
+            fields_.push_back({ from, to - from, esc });
+    };
+    const auto end_field = [&](size_t i)
     {
-        // remove double sets of quotes which parse as the double quote literal
-        line.Replace("\"\"", "\x1a");
-        // if there is an unclosed quote, the line has an in-field newline char
-        while (splitLinePattern.Matches(line))
+        switch (state)
         {
-            // append the next line
-            line += "\n" + txtFile.GetNextLine();
+        case FIELD_START:
+            add_field(i, i, false);
+            break;
+        case UNQUOTED:
+            add_field(begin, i, escaped);
+            break;
+        case QUOTE:
+            if (escaped)
+                add_field(begin, i, true);
+            else
+                add_field(begin + 1, i - 1, false);
+            break;
+        case QUOTED: // the quote is not closed before the end of file
+            add_field(begin, i, true);
+            break;
         }
-        // add double quotes back in
-        line.Replace("\x1a", "\"\"");
-        csv2tab_separated_values(line, delimiter_);
-        wxStringTokenizer tkz(line, "\t", wxTOKEN_RET_EMPTY_ALL);
-        itemsTable_.push_back(std::vector<ValueAndType>());
-
-        // Tokens in row
-        while (tkz.HasMoreTokens())
+        state = FIELD_START;
+    };
+    const auto end_row = [&]()
+    {
+        rows_.push_back(fields_.size());
+        items = 0;
+    };
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        const char c = data[i];
+        switch (state)
         {
-            if (itemsTable_[row].size() >= itemsInLine)
-                break;
+        case QUOTED:
+            // delimiters and line breaks are part of the field
+            if (c == '"')
+                state = QUOTE;
+            else if (c == '\r')
+                escaped = true;
+            continue;
+        case QUOTE:
+            if (c == '"')
+            {
+                escaped = true;
+                state = QUOTED;
+                continue;
+            }
+            break;
+        case FIELD_START:
+            begin = i;
+            escaped = false;
+            if (c == '"')
+            {
+                state = QUOTED;
+                continue;
+            }
+            break;
+        case UNQUOTED:
+            break;
+        }
 
-            wxString token = tkz.GetNextToken();
-            itemsTable_[row].push_back(token);
+        if (c == '\n' || c == '\r')
+        {
+            // a line without any delimiter has no items
+            if (state != FIELD_START || items > 0)
+                end_field(i);
+            end_row();
+            if (c == '\r' && i + 1 < size && data[i + 1] == '\n')
+                ++i;
+        }
+        else if (c == d0 && (dlen == 1 || buffer_.compare(i, dlen, delimiter) == 0))
+        {
+            end_field(i);
+            i += dlen - 1;
         }
+        else if (state != UNQUOTED)
+        {
+            // text after a closing quote is kept as part of the field
+            escaped = escaped || state == QUOTE;
+            state = UNQUOTED;
+        }
+    }
 
-        ++row;
+    // last line without a line break
+    if (state != FIELD_START || items > 0)
+    {
+        end_field(size);
+        end_row();
     }
+}
 
-    txtFile.Close();
-    return true;
+wxString FileCSV::Decode(const char* data, size_t length) const
+{
+    if (length == 0)
+        return wxEmptyString;
+    if (utf8_)
+        return wxString::FromUTF8(data, length);
+    return wxString(data, encoding_, length);
+}
+
+unsigned int FileCSV::GetLinesCount() const
+{
+    if (rows_.empty())
+        return TableBasedFile::GetLinesCount();
+    return rows_.size() - 1;
+}
+
+unsigned int FileCSV::GetItemsCount(unsigned int line) const
+{
+    if (rows_.empty())
+        return TableBasedFile::GetItemsCount(line);
+    if (line >= GetLinesCount())
+        return 0;
+    return rows_[line + 1] - rows_[line];
+}
+
+wxString FileCSV::GetItem(unsigned int line, unsigned int itemInLine) const
+{
+    if (rows_.empty())
+        return TableBasedFile::GetItem(line, itemInLine);
+    if (itemInLine >= GetItemsCount(line))
+        return wxEmptyString;
+
+    const Field& field = fields_[rows_[line] + itemInLine];
+    const char* data = buffer_.data() + field.begin;
+    if (!field.escaped)
+        return Decode(data, field.length);
+
+    // drop the quotes, collapse "" pairs and normalize line breaks
+    std::string value;
+    value.reserve(field.length);
+    bool quoted = false;
+    for (size_t i = 0; i < field.length; ++i)
+    {
+        const char c = data[i];
+        if (c == '"')
+        {
+            if (quoted && i + 1 < field.length && data[i + 1] == '"')
+            {
+                value += '"';
+                ++i;
+            }
+            else
+                quoted = !quoted;
+        }
+        else if (c == '\r')
+        {
+            value += '\n';
+            if (i + 1 < field.length && data[i + 1] == '\n')
+                ++i;
+        }
+        else
+            value += c;
+    }
+    return Decode(value.data(), value.length());
 }
 
 bool FileCSV::Save(const wxString& fileName)
@@ -22,6 +22,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <wx/string.h>
 #include <wx/window.h>
 #include <wx/convauto.h>
+#include <string>
 #include <vector>
 
 // Generic interface for importing data from a file.
@@ -117,15 +118,36 @@ protected:
 };
 
 // CSV parser
+// Load() reads the file in one block and records the field boundaries in a
+// single pass; GetItem() decodes a field only when it is asked for.
+// Export still goes through the TableBasedFile string table.
 class FileCSV : public TableBasedFile
 {
 public:
     FileCSV(wxWindow *pParentWindow, wxConvAuto encoding, wxString delimiter);
     virtual bool Load(const wxString& fileName, unsigned int itemsInLine);
     virtual bool Save(const wxString& fileName);
+    virtual unsigned int GetLinesCount() const;
+    virtual unsigned int GetItemsCount(unsigned int line) const;
+    virtual wxString GetItem(unsigned int line, unsigned int itemInLine) const;
 protected:
     wxConvAuto encoding_;
     wxString delimiter_;
+private:
+    // Slice of buffer_; escaped slices still hold their quotes, "" pairs or CR
+    struct Field
+    {
+        size_t begin;
+        size_t length;
+        bool escaped;
+    };
+    void Index(unsigned int itemsInLine);
+    wxString Decode(const char* data, size_t length) const;
+
+    std::string buffer_;
+    bool utf8_ = false;         // buffer_ was transcoded from a UTF-16/32 file or had a UTF-8 BOM
+    std::vector<Field> fields_;
+    std::vector<size_t> rows_;  // first field of each row in fields_, followed by fields_.size()
 };
 
 // XML parser
@@ -18,6 +18,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include "constants.h"
 #include "qif_export.h"
+#include <optional>
 #include "util.h"
 #include "paths.h"
 #include "export.h"
@@ -441,7 +442,11 @@ void mmQIFExportDialog::mmExportQIF()
     wxStringClientData* data_obj = static_cast<wxStringClientData*>(m_choiceDateFormat->GetClientObject(m_choiceDateFormat->GetSelection()));
     const wxString dateMask = data_obj->GetData();
 
-    wxString buffer;
+    // the output is written as it is produced, the JSON buffer is emptied into it chunk by chunk
+    mmExportStream output(log_field_, write_to_file ? fileName : wxString());
+    if (!output.IsOk())
+        return mmErrorDialogs::InvalidFile(m_text_ctrl_);
+
     StringBuffer json_buffer;
     PrettyWriter<StringBuffer> json_writer(json_buffer);
     json_writer.StartObject();
@@ -449,7 +454,7 @@ void mmQIFExportDialog::mmExportQIF()
     //Export categories
     if (m_type == QIF && exp_categ)
     {
-        buffer << mmExportTransaction::getCategoriesQIF();
+        output << mmExportTransaction::getCategoriesQIF();
         numCategories = Model_Category::instance().all().size();
         sErrorMsg << _t("Categories exported") << "\n";
     }
@@ -467,10 +472,11 @@ void mmQIFExportDialog::mmExportQIF()
 
     std::map<int64 /*account ID*/, wxString> allAccounts4Export;
     wxArrayInt64 allPayees4Export;
-    const wxString RefType = Model_Checking::refTypeName;
-    wxArrayInt64 allAttachments4Export;
-    wxArrayInt64 allCustomFields4Export;
+    mmExportTransaction::Id_Set allAttachments4Export;
+    mmExportTransaction::Id_Set allCustomFields4Export;
     wxArrayInt64 allTags4Export;
+    // payees and tags are exported in the order they are first seen
+    mmExportTransaction::Id_Set payees_seen, tags_seen;
     const auto transactions = Model_Checking::instance().find(
         Model_Checking::STATUS(Model_Checking::STATUS_ID_VOID, NOT_EQUAL));
 
@@ -479,20 +485,31 @@ void mmQIFExportDialog::mmExportQIF()
         json_writer.Key("transactions");
         json_writer.StartArray();
 
-        /* Array to store QIF tarts for selected accounts */
-        std::map<int64 /*account ID*/, wxString> extraTransfers;
+        /* QIF and CSV rows, written grouped by account once all are known */
+        struct Export_Row
+        {
+            bool extra;         // second leg of a transfer for the other account
+            int64 account_id;
+            bool reverce;
+            size_t i;           // position in transactions
+        };
+        std::vector<Export_Row> rows;
 
         wxProgressDialog progressDlg(_tu("Please wait…"), _t("Exporting")
             , 100, this, wxPD_APP_MODAL | wxPD_CAN_ABORT);
 
         const auto splits = Model_Splittransaction::instance().get_all();
         const auto tags = Model_Taglink::instance().get_all(Model_Checking::refTypeName);
+        std::optional<mmExportTransaction::Links> links;
+        if (m_type == JSON)
+            links.emplace();
 
         const wxString begin_date = fromDateCtrl_->GetValue().FormatISODate();
         const wxString end_date = toDateCtrl_->GetValue().FormatISODate();
 
-        for (const auto& transaction : transactions)
+        for (size_t i = 0; i < transactions.size(); ++i)
         {
+            const auto& transaction = transactions[i];
             if (!transaction.DELETEDTIME.IsEmpty()) continue;
             wxString strDate = Model_Checking::TRANSDATE(transaction).FormatISODate();
             //Filtering
@@ -514,103 +531,109 @@ void mmQIFExportDialog::mmExportQIF()
                 break; // abort processing
 
             bool is_reverce = false;
-            wxString trx_str;
-            Model_Checking::Full_Data full_tran(transaction, splits, tags);
             int64 account_id = transaction.ACCOUNTID;
 
-            switch (m_type)
+            if (m_type == JSON)
             {
-            case JSON:
-                mmExportTransaction::getTransactionJSON(json_writer, full_tran);
+                Model_Checking::Full_Data full_tran(transaction, splits, tags);
+                mmExportTransaction::getTransactionJSON(json_writer, full_tran, *links);
+                output.Write(json_buffer);
                 allAccounts4Export[account_id] = "";
-                if (std::find(allPayees4Export.begin(), allPayees4Export.begin(), full_tran.PAYEEID) == allPayees4Export.end()
-                    && full_tran.TRANSCODE != Model_Checking::TYPE_NAME_TRANSFER) {
+                if (full_tran.TRANSCODE != Model_Checking::TYPE_NAME_TRANSFER
+                    && payees_seen.insert(full_tran.PAYEEID).second) {
                     allPayees4Export.push_back(full_tran.PAYEEID);
                 }
 
-                if (!Model_Attachment::instance().FilterAttachments(RefType, full_tran.id()).empty()
-                    && std::find(allAttachments4Export.begin(), allAttachments4Export.end(), full_tran.TRANSID) == allAttachments4Export.end()) {
-                    allAttachments4Export.push_back(full_tran.TRANSID);
-                }
+                if (links->attachments.count(full_tran.TRANSID) > 0)
+                    allAttachments4Export.insert(full_tran.TRANSID);
 
-                for (const auto & entry : Model_CustomFieldData::instance().find(Model_CustomFieldData::REFID(full_tran.id())))
-                {
-                    if (std::find(allCustomFields4Export.begin(), allCustomFields4Export.end(), entry.FIELDATADID) == allCustomFields4Export.end()) {
-                        allCustomFields4Export.push_back(entry.FIELDATADID);
-                    }
+                const auto data = links->field_data.find(full_tran.TRANSID);
+                if (data != links->field_data.end()) {
+                    for (const auto& entry : data->second)
+                        allCustomFields4Export.insert(entry.FIELDATADID);
                 }
 
                 // store tags from the transaction
                 for (const auto& tag : full_tran.m_tags)
                 {
-                    if (std::find(allTags4Export.begin(), allTags4Export.end(), tag.TAGID) == allTags4Export.end())
+                    if (tags_seen.insert(tag.TAGID).second)
                         allTags4Export.push_back(tag.TAGID);
                 }
                 // store tags from the splits
                 for (const auto& split : full_tran.m_splits)
                 {
-                    for (const auto& taglink : Model_Taglink::instance().get(Model_Splittransaction::refTypeName, split.SPLITTRANSID))
+                    const auto split_tags = links->split_tags.find(split.SPLITTRANSID);
+                    if (split_tags == links->split_tags.end())
+                        continue;
+                    for (const auto& taglink : split_tags->second)
                     {
-                        if (std::find(allTags4Export.begin(), allTags4Export.end(), taglink.second) == allTags4Export.end())
-                            allTags4Export.push_back(taglink.second);
-                    }
-                }
-
-                break;
-
-            case QIF:
-
-                if (Model_Checking::is_transfer(transaction.TRANSCODE))
-                {
-                    if (std::find(selected_accounts_id_.begin(), selected_accounts_id_.end(), transaction.ACCOUNTID) == selected_accounts_id_.end()) {
-                        is_reverce = true;
-                        account_id = transaction.TOACCOUNTID;
-                    }
-
-                    if (transaction.TRANSAMOUNT != transaction.TOTRANSAMOUNT) {
-                        const auto trx2_str = mmExportTransaction::getTransactionQIF(full_tran, dateMask, !is_reverce);
-                        extraTransfers[is_reverce ? transaction.ACCOUNTID : transaction.TOACCOUNTID] += trx2_str;
+                        if (tags_seen.insert(taglink.TAGID).second)
+                            allTags4Export.push_back(taglink.TAGID);
                     }
                 }
+                continue;
+            }
 
-                trx_str = mmExportTransaction::getTransactionQIF(full_tran, dateMask, is_reverce);
-                allAccounts4Export[account_id] += trx_str;
-                break;
-
-            case CSV:
-
-                if (Model_Checking::is_transfer(transaction.TRANSCODE))
-                {
-                    if (std::find(selected_accounts_id_.begin(), selected_accounts_id_.end(), transaction.ACCOUNTID) == selected_accounts_id_.end()) {
-                        is_reverce = true;
-                        account_id = transaction.TOACCOUNTID;
-                    }
-                    const auto trx2_str = mmExportTransaction::getTransactionCSV(full_tran, dateMask, !is_reverce);
-                    extraTransfers[is_reverce ? transaction.ACCOUNTID : transaction.TOACCOUNTID] += trx2_str;
+            if (Model_Checking::is_transfer(transaction.TRANSCODE))
+            {
+                if (std::find(selected_accounts_id_.begin(), selected_accounts_id_.end(), transaction.ACCOUNTID) == selected_accounts_id_.end()) {
+                    is_reverce = true;
+                    account_id = transaction.TOACCOUNTID;
                 }
 
-                trx_str = mmExportTransaction::getTransactionCSV(full_tran, dateMask, is_reverce);
-                allAccounts4Export[account_id] += trx_str;
-                break;
+                // QIF only needs the other leg when the amounts differ
+                if (m_type == CSV || transaction.TRANSAMOUNT != transaction.TOTRANSAMOUNT)
+                    rows.push_back({ true, is_reverce ? transaction.ACCOUNTID : transaction.TOACCOUNTID, !is_reverce, i });
             }
+
+            rows.push_back({ false, account_id, is_reverce, i });
+            allAccounts4Export[account_id] = "";
         }
         json_writer.EndArray();
 
         switch (m_type)
         {
         case QIF:
-            //Export accounts
-            for (const auto &entry : allAccounts4Export) {
-                buffer << mmExportTransaction::getAccountHeaderQIF(entry.first);
-                buffer << entry.second;
+        case CSV:
+        {
+            if (m_type == CSV) {
+                output
+                    << _t("ID") << delimiter
+                    << _t("Date") << delimiter
+                    << _t("Status") << delimiter
+                    << _t("Type") << delimiter
+                    << _t("Account") << delimiter
+                    << _t("Payee") << delimiter
+                    << _t("Category") << delimiter
+                    << _t("Amount") << delimiter
+                    << _t("Currency") << delimiter
+                    << _t("Number") << delimiter
+                    << _t("Notes")
+                    << "\n";
             }
 
-            //Append extra transters
-            for (const auto &entry : extraTransfers) {
-                buffer << mmExportTransaction::getAccountHeaderQIF(entry.first);
-                buffer << entry.second;
+            //Export accounts, then append extra transfers
+            std::stable_sort(rows.begin(), rows.end(), [](const Export_Row& a, const Export_Row& b) {
+                return a.extra != b.extra ? b.extra : a.account_id < b.account_id;
+            });
+            for (size_t j = 0; j < rows.size(); ++j)
+            {
+                const Export_Row& row = rows[j];
+                if (j % 100 == 0 && !progressDlg.Pulse(wxString::Format(_t("Exporting transaction %zu"), j)))
+                    break;
+
+                Model_Checking::Full_Data full_tran(transactions[row.i], splits, tags);
+                if (m_type == QIF) {
+                    if (j == 0 || row.extra != rows[j - 1].extra || row.account_id != rows[j - 1].account_id)
+                        output << mmExportTransaction::getAccountHeaderQIF(row.account_id);
+                    output << mmExportTransaction::getTransactionQIF(full_tran, dateMask, row.reverce);
+                }
+                else {
+                    output << mmExportTransaction::getTransactionCSV(full_tran, dateMask, row.reverce);
+                }
             }
             break;
+        }
 
         case JSON:
             mmExportTransaction::getAccountsJSON(json_writer, allAccounts4Export);
@@ -619,56 +642,16 @@ void mmQIFExportDialog::mmExportQIF()
             mmExportTransaction::getCustomFieldsJSON(json_writer, allCustomFields4Export);
             mmExportTransaction::getTagsJSON(json_writer, allTags4Export);
             break;
-
-        case CSV:
-            buffer
-                << _t("ID") << delimiter
-                << _t("Date") << delimiter
-                << _t("Status") << delimiter
-                << _t("Type") << delimiter
-                << _t("Account") << delimiter
-                << _t("Payee") << delimiter
-                << _t("Category") << delimiter
-                << _t("Amount") << delimiter
-                << _t("Currency") << delimiter
-                << _t("Number") << delimiter
-                << _t("Notes")
-                << "\n";
-
-            //Export accounts
-            for (const auto &entry : allAccounts4Export) {
-                buffer << entry.second;
-            }
-
-            //Append extra transters
-            for (const auto &entry : extraTransfers) {
-                buffer << entry.second;
-            }
-            break;
         }
     }
     json_writer.EndObject();
 
-    switch (m_type)
-    {
-    case JSON:
-        buffer << wxString::FromUTF8(json_buffer.GetString()); break;
-    case QIF:
-        break;
-    }
+    if (m_type == JSON)
+        output.Write(json_buffer, true);
+    output.Close();
 
-    if (write_to_file)
-    {
-        wxFileOutputStream output(fileName);
-        wxTextOutputStream text(output);
-        text << buffer;
-        output.Close();
-        if (numCategories || numRecords || allAccounts4Export.size())
-            m_text_ctrl_->Clear();
-    }
-    else {
-        *log_field_ << buffer;
-    }
+    if (write_to_file && (numCategories || numRecords || allAccounts4Export.size()))
+        m_text_ctrl_->Clear();
 
     wxString msg = "";
     if (numCategories > 0) {
@@ -17,11 +17,13 @@ along with this program; if not, write to the Free Software
 Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 ********************************************************/
 
+#include <limits>
 #include <wx/progdlg.h>
 #include <wx/dataview.h>
 
 #include "qif_import_gui.h"
 #include "qif_import.h"
+#include "import_engine.h"
 #include "export.h"
 #include "constants.h"
 #include "mmSimpleDialogs.h"
@@ -1051,6 +1053,7 @@ void mmQIFImportDialog::OnOk(wxCommandEvent& WXUNUSED(event))
     if (msgDlg.ShowModal() == wxID_YES)
     {
         getOrCreateAccounts();
+        mmImportEngine engine;
         int nTransactions = vQIF_trxs_.size();
         wxProgressDialog progressDlg(_tu("Please wait…"), _t("Importing")
             , nTransactions + 1, this, wxPD_APP_MODAL | wxPD_CAN_ABORT | wxPD_AUTO_HIDE);
@@ -1058,11 +1061,11 @@ void mmQIFImportDialog::OnOk(wxCommandEvent& WXUNUSED(event))
         bool is_webbapp_enabled = mmWebApp::MMEX_WebApp_UpdateAccount();
 
         progressDlg.Update(1, _t("Importing Payees"));
-        getOrCreatePayees();
+        getOrCreatePayees(engine);
         if (is_webbapp_enabled)
             is_webbapp_enabled = mmWebApp::MMEX_WebApp_UpdatePayee();
         progressDlg.Update(1, _t("Importing Categories"));
-        getOrCreateCategories();
+        getOrCreateCategories(engine);
         if (is_webbapp_enabled)
             mmWebApp::MMEX_WebApp_UpdateCategory();
 
@@ -1080,7 +1083,7 @@ void mmQIFImportDialog::OnOk(wxCommandEvent& WXUNUSED(event))
 
         for (const auto& entry : vQIF_trxs_)
         {
-            if (count % 100 == 0 || count == nTransactions)
+            if (engine.is_progress_due())
             {
                 if (!progressDlg.Update(count
                     , wxString::Format(_t("Importing transaction %1$i of %2$i"), count, nTransactions))) // if cancel clicked
@@ -1097,8 +1100,8 @@ void mmQIFImportDialog::OnOk(wxCommandEvent& WXUNUSED(event))
                 if (dateToCheckBox_->IsChecked() && strDate > end_date)
                     continue;
                 
-                Model_Account::Data* account = Model_Account::instance().get(trx->ACCOUNTID);
-                Model_Account::Data* toAccount = Model_Account::instance().get(trx->TOACCOUNTID);
+                Model_Account::Data* account = engine.getAccount(trx->ACCOUNTID);
+                Model_Account::Data* toAccount = engine.getAccount(trx->TOACCOUNTID);
 
                 if ((trx->TRANSDATE < account->STATEMENTDATE && account->STATEMENTLOCKED.GetValue()) ||
                     (toAccount && (trx->TRANSDATE < toAccount->STATEMENTDATE && toAccount->STATEMENTLOCKED.GetValue())))
@@ -1113,29 +1116,17 @@ void mmQIFImportDialog::OnOk(wxCommandEvent& WXUNUSED(event))
 
                 // Save Transaction Tags
                 wxString tagStr = (entry.find(Category) != entry.end() ? entry.at(Category).AfterFirst('/') : "");
-                Model_Taglink::Cache taglinks;
+                // Just keep the tag ids since we don't know the TRANSID yet
+                wxArrayInt64 tagIDs;
                 if (!tagStr.IsEmpty())
                 {
-                    wxString reftype = Model_Checking::refTypeName;
                     wxStringTokenizer tagTokens = wxStringTokenizer(tagStr, ":");
                     while (tagTokens.HasMoreTokens())
                     {
                         wxString tagname = tagTokens.GetNextToken().Trim(false).Trim();
                         // make tag names single-word
                         tagname.Replace(" ", "_");
-                        Model_Tag::Data* tag = Model_Tag::instance().get(tagname);
-                        if (!tag)
-                        {
-                            tag = Model_Tag::instance().create();
-                            tag->TAGNAME = tagname;
-                            tag->ACTIVE = 1;
-                            tag->TAGID = Model_Tag::instance().save(tag);
-                        }
-                        Model_Taglink::Data* taglink = Model_Taglink::instance().create();
-                        taglink->REFTYPE = reftype;
-                        taglink->TAGID = tag->TAGID;
-                        // Just cache the new taglink since we don't know the TRANSID yet
-                        taglinks.push_back(taglink);
+                        tagIDs.push_back(engine.getTagID(tagname));
                     }
                 }
 
@@ -1144,19 +1135,19 @@ void mmQIFImportDialog::OnOk(wxCommandEvent& WXUNUSED(event))
                 if (trx->TRANSCODE == transferStr && trx->TOTRANSAMOUNT > 0.0)
                 {
                     // The "From" tags are stored with key <2, index of from transaction>
-                    m_txnTaglinks[std::make_pair(2, transfer_from_data_set.size())] = taglinks;
+                    m_txnTagIDs[std::make_pair(2, transfer_from_data_set.size())] = tagIDs;
                     transfer_from_data_set.push_back(trx);
                 }
                 else if (trx->TRANSCODE == transferStr && trx->TOTRANSAMOUNT <= 0.0)
                 {
                     // The "To" tags are stored with key <1, index of 'to' transaction>
-                    m_txnTaglinks[std::make_pair(1, transfer_to_data_set.size())] = taglinks;
+                    m_txnTagIDs[std::make_pair(1, transfer_to_data_set.size())] = tagIDs;
                     transfer_to_data_set.push_back(trx);
                 }
                 else
                 {
                     // The non-transfer tags are stored with key <0, index of transaction>
-                    m_txnTaglinks[std::make_pair(0, trx_data_set.size())] = taglinks;
+                    m_txnTagIDs[std::make_pair(0, trx_data_set.size())] = tagIDs;
                     trx_data_set.push_back(trx);
                 }
             }
@@ -1177,46 +1168,48 @@ void mmQIFImportDialog::OnOk(wxCommandEvent& WXUNUSED(event))
         mergeTransferPair(transfer_to_data_set, transfer_from_data_set);
         appendTransfers(trx_data_set, transfer_to_data_set);
 
-        //Search for duplicates for transfers
-        for (auto &trx : trx_data_set)
+        // Flag transactions that are already in their account, e.g. from an overlapping
+        // statement or the other side of a transfer imported earlier
+        int first_day = std::numeric_limits<int>::max();
+        int last_day = std::numeric_limits<int>::min();
+        std::vector<int> days(trx_data_set.size());
+        for (size_t i = 0; i < trx_data_set.size(); i++)
         {
-            if (!Model_Checking::is_transfer(trx))
+            if (!ModelBase::to_day(trx_data_set[i]->TRANSDATE, days[i]))
+                days[i] = std::numeric_limits<int>::min();
+            else
+            {
+                first_day = std::min(first_day, days[i]);
+                last_day = std::max(last_day, days[i]);
+            }
+        }
+        size_t duplicates = 0;
+        if (first_day <= last_day)
+            engine.setDuplicateWindow(first_day, last_day);
+        for (size_t i = 0; i < trx_data_set.size(); i++)
+        {
+            Model_Checking::Data* trx = trx_data_set[i];
+            const double flow = Model_Checking::account_flow(trx, trx->ACCOUNTID);
+            if (days[i] == std::numeric_limits<int>::min() || flow == 0.0)
                 continue;
-            wxDate dt;
-            dt.ParseISODate(trx->TRANSDATE);
-            const auto data = Model_Checking::instance().find(
-                Model_Checking::TRANSDATE(dt)
-                , Model_Checking::ACCOUNTID(trx->ACCOUNTID)
-                , Model_Checking::TOACCOUNTID(trx->TOACCOUNTID)
-                , Model_Checking::NOTES(trx->NOTES)
-                , Model_Checking::TRANSACTIONNUMBER(trx->TRANSACTIONNUMBER)
-                , Model_Checking::TRANSCODE(Model_Checking::TYPE_ID_TRANSFER)
-                , Model_Checking::TRANSAMOUNT(trx->TRANSAMOUNT)
-            );
-            if (data.size() > 0)
+            // a fuzzy match may be a legitimate repeat, so it keeps its status and is only reported
+            const auto duplicate = engine.duplicate(trx->ACCOUNTID, days[i], flow, trx->PAYEEID);
+            if (duplicate == mmImportEngine::DUPLICATE_EXACT)
                 trx->STATUS = Model_Checking::STATUS_KEY_DUPLICATE;
+            if (duplicate != mmImportEngine::DUPLICATE_NONE)
+                duplicates++;
         }
+        if (duplicates > 0)
+            *log_field_ << wxString::Format(_t("Possible Duplicates: %zu"), duplicates) << "\n";
         // At this point all transactions and tags have been merged into single sets
-        Model_Taglink::instance().Savepoint();
         for (int i = 0; i < static_cast<int>(trx_data_set.size()); i++)
-        {
-            if (!m_txnTaglinks[std::make_pair(0, i)].empty())
-            {
-                // we need to know the transid for the taglink, so save the transaction first
-                int64 transid = Model_Checking::instance().save(trx_data_set[i]);
-                // apply that transid to all associated tags
-                for (const auto& taglink : m_txnTaglinks[std::make_pair(0, i)])
-                    taglink->REFID = transid;
-                // save the block of taglinks
-                Model_Taglink::instance().save(m_txnTaglinks[std::make_pair(0, i)]);
-            }
-        }
-        Model_Taglink::instance().ReleaseSavepoint();
-        Model_Checking::instance().save(trx_data_set);
+            engine.append(trx_data_set[i], m_txnTagIDs[std::make_pair(0, i)]);
+        engine.flush();
         progressDlg.Update(count, _t("Importing Split transactions"));
         joinSplit(trx_data_set, m_splitDataSets);
         saveSplit();
 
+        *log_field_ << engine.throughput(count) << "\n";
         sMsg = _t("Import finished successfully") + "\n" + wxString::Format(_t("Total Imported: %zu"), trx_data_set.size());
         trx_data_set.clear();
         vQIF_trxs_.clear();
@@ -1284,7 +1277,7 @@ void mmQIFImportDialog::appendTransfers(Model_Checking::Cache &destination, Mode
     // need to keep track of the new index for the taglinks
     for (int i = 0; i < static_cast<int>(target.size()); i++)
     {
-        m_txnTaglinks[std::make_pair(0, destination.size())] = m_txnTaglinks[std::make_pair(1, i)];
+        m_txnTagIDs[std::make_pair(0, destination.size())] = m_txnTagIDs[std::make_pair(1, i)];
         destination.push_back(target[i]);
     }
 }
@@ -1308,7 +1301,7 @@ bool mmQIFImportDialog::mergeTransferPair(Model_Checking::Cache& to, Model_Check
             refTrxTo->TOTRANSAMOUNT = refTrxFrom->TRANSAMOUNT;
             from.erase(from.begin() + i);
             // a match is found so erase the 'from' taglinks
-            m_txnTaglinks.erase(std::make_pair(2, i));
+            m_txnTagIDs.erase(std::make_pair(2, i));
             pair_found = true;
             break;
         }
@@ -1323,7 +1316,7 @@ bool mmQIFImportDialog::mergeTransferPair(Model_Checking::Cache& to, Model_Check
         std::swap(from[i]->ACCOUNTID, from[i]->TOACCOUNTID);
         // also need to move the 'from' taglinks to the 'to' taglinks list, keeping track
         // of the new transaction indices
-        m_txnTaglinks[std::make_pair(1, to.size())] = m_txnTaglinks[std::make_pair(2, i)];
+        m_txnTagIDs[std::make_pair(1, to.size())] = m_txnTagIDs[std::make_pair(2, i)];
         to.push_back(from[i]);
     }
 
@@ -1602,7 +1595,7 @@ int64 mmQIFImportDialog::getOrCreateAccounts()
     return m_QIFaccountsID.size();
 }
 
-void mmQIFImportDialog::getOrCreatePayees()
+void mmQIFImportDialog::getOrCreatePayees(mmImportEngine& engine)
 {
     Model_Payee::instance().Savepoint();
     
@@ -1612,47 +1605,23 @@ void mmQIFImportDialog::getOrCreatePayees()
         if (m_QIFpayeeNames.find(item) != m_QIFpayeeNames.end() && std::get<0>(m_QIFpayeeNames[item]) != -1) continue;
 
         // the payee doesn't exist or match a pattern, so create one
-        Model_Payee::Data* p = Model_Payee::instance().create();
-        p->PAYEENAME = item;
-        p->ACTIVE = 1;
-        p->CATEGID = -1;
-        wxString sMsg = wxString::Format(_t("Added payee: %s"), item);
-        log_field_->AppendText(wxString() << sMsg << "\n");
-        m_QIFpayeeNames[item] = std::make_tuple(Model_Payee::instance().save(p), p->PAYEENAME, "");
-        
+        if (engine.getPayeeID(item, false) == -1)
+        {
+            wxString sMsg = wxString::Format(_t("Added payee: %s"), item);
+            log_field_->AppendText(wxString() << sMsg << "\n");
+        }
+        m_QIFpayeeNames[item] = std::make_tuple(engine.getPayeeID(item), item, "");
     }
 
     Model_Payee::instance().ReleaseSavepoint();
 }
 
-void mmQIFImportDialog::getOrCreateCategories()
+void mmQIFImportDialog::getOrCreateCategories(mmImportEngine& engine)
 {
-    wxArrayString temp;
-    for (const auto &item : m_QIFcategoryNames)
-    {
-        wxString categStr;
-        wxStringTokenizer token(item.first, ":");
-        int64 parentID = -1;
-        while(token.HasMoreTokens()){
-            categStr = token.GetNextToken().Trim(false).Trim();
-            Model_Category::Data* c = Model_Category::instance().get(categStr, parentID);
-            if (temp.Index(categStr + wxString::Format(":%lld", parentID)) == wxNOT_FOUND) {
-
-                if (!c)
-                {
-                    c = Model_Category::instance().create();
-                    c->CATEGNAME = categStr;
-                    c->ACTIVE = 1;
-                    c->PARENTID = parentID;
-                    Model_Category::instance().save(c);
-                }
-                temp.Add(categStr + wxString::Format(":%lld", parentID));
-            }
-            parentID = c->CATEGID;
-
-        }
-        m_QIFcategoryNames[item.first] = parentID;
-    }
+    Model_Category::instance().Savepoint();
+    for (auto& item : m_QIFcategoryNames)
+        item.second = engine.getCategoryID(item.first);
+    Model_Category::instance().ReleaseSavepoint();
 }
 
 int64 mmQIFImportDialog::get_last_imported_acc()
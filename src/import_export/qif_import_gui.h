@@ -22,6 +22,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "Model_Checking.h"
 #include "mmSimpleDialogs.h"
 
+class mmImportEngine;
+
 class mmDatePickerCtrl;
 class wxDataViewListCtrl;
 class mmQIFImport;
@@ -67,8 +69,8 @@ private:
     void save_file_name();
     bool mmReadQIFFile();
     int64 getOrCreateAccounts();
-    void getOrCreatePayees();
-    void getOrCreateCategories();
+    void getOrCreatePayees(mmImportEngine& engine);
+    void getOrCreateCategories(mmImportEngine& engine);
     bool completeTransaction(std::unordered_map<int, wxString>& trx, const wxString& accName);
     bool completeTransaction(/*in*/ const std::unordered_map<int, wxString>& i, /*out*/ Model_Checking::Data* trx, wxString& msg);
     bool mergeTransferPair(Model_Checking::Cache& to, Model_Checking::Cache& from);
@@ -88,7 +90,7 @@ private:
     std::unordered_map<wxString, int64> m_QIFcategoryNames;
     std::vector<Model_Splittransaction::Cache> m_splitDataSets;
     std::map<int, std::map<int, Model_Taglink::Cache>> m_splitTaglinks;
-    std::map<std::pair<int, int>, Model_Taglink::Cache> m_txnTaglinks;
+    std::map<std::pair<int, int>, wxArrayInt64> m_txnTagIDs;
 
     wxString m_accountNameStr;
     wxString m_dateFormatStr;
@@ -25,6 +25,7 @@
 #include <string>
 #include <memory>
 #include <regex>
+#include <limits>
 
 #include <wx/xml/xml.h>
 #include <wx/spinctrl.h>
@@ -42,6 +43,7 @@
 #include "util.h"
 #include "webapp.h"
 #include "parsers.h"
+#include "import_engine.h"
 #include "payeedialog.h"
 #include "categdialog.h"
 
@@ -1238,7 +1240,7 @@ void mmUnivCSVDialog::saveAccountPresets()
     );
 }
 
-bool mmUnivCSVDialog::validateData(tran_holder & holder, wxString& message)
+bool mmUnivCSVDialog::validateData(tran_holder & holder, wxString& message, mmImportEngine& engine)
 {
     bool is_valid = true;
     if (!holder.valid) {
@@ -1256,19 +1258,11 @@ bool mmUnivCSVDialog::validateData(tran_holder & holder, wxString& message)
     Model_Payee::Data* payee = Model_Payee::instance().get(holder.PayeeID);
     if (!payee)
     {
-        Model_Payee::Data* u = Model_Payee::instance().get(_t("Unknown"));
-        if (!u) {
-            Model_Payee::Data *p = Model_Payee::instance().create();
-            p->PAYEENAME = _t("Unknown");
-            p->ACTIVE = 1;
-            p->CATEGID = -1;
-            holder.PayeeID = Model_Payee::instance().save(p);
-            const wxString& sMsg = wxString::Format(_t("Added payee: %s"), p->PAYEENAME);
+        if (engine.getPayeeID(_t("Unknown"), false) == -1) {
+            const wxString& sMsg = wxString::Format(_t("Added payee: %s"), _t("Unknown"));
             log_field_->AppendText(wxString() << sMsg << "\n");
         }
-        else {
-            holder.PayeeID = u->PAYEEID;
-        }
+        holder.PayeeID = engine.getPayeeID(_t("Unknown"));
     }
     else
     {
@@ -1278,20 +1272,7 @@ bool mmUnivCSVDialog::validateData(tran_holder & holder, wxString& message)
     }
 
     if (holder.CategoryID == -1) //The category name is missing in SCV file and not assigned for the payee
-    {
-        Model_Category::Data* categ = Model_Category::instance().get(_t("Unknown"), int64(-1));
-        if (categ) {
-            holder.CategoryID = categ->CATEGID;
-        }
-        else
-        {
-            Model_Category::Data *c = Model_Category::instance().create();
-            c->CATEGNAME = _t("Unknown");
-            c->ACTIVE = 1;
-            c->PARENTID = -1;
-            holder.CategoryID = Model_Category::instance().save(c);
-        }
-    }
+        holder.CategoryID = engine.getCategoryID(_t("Unknown"));
 
     return is_valid;
 }
@@ -1346,6 +1327,7 @@ void mmUnivCSVDialog::OnImport(wxCommandEvent& WXUNUSED(event))
     long lastRow = totalLines - m_spinIgnoreLastRows_->GetValue();
     const long linesToImport = lastRow - firstRow;
     long countEmptyLines = 0;
+    long countDuplicates = 0;
     int color_id = colorCheckBox_->IsChecked() ? colorButton_->GetColorId() : -1;
     if (colorCheckBox_->IsChecked() && (color_id < 0 || color_id > 7) ) {
         return mmErrorDialogs::ToolTip4Object(colorButton_, _t("Color"), _t("Invalid value"), wxICON_ERROR);
@@ -1365,15 +1347,43 @@ void mmUnivCSVDialog::OnImport(wxCommandEvent& WXUNUSED(event))
     m_reverce_sign = m_choiceAmountFieldSign->GetCurrentSelection() == PositiveIsWithdrawal;
     // A place to store all rejected rows to display after import
     wxString rejectedRows;
-    wxString reftype = Model_Checking::refTypeName;
+    // Per line messages, added to the log field once instead of once per line
+    wxString logLines;
+    mmImportEngine engine;
+
+    // Only the file's own dates need indexing for duplicate detection
+    int first_day = std::numeric_limits<int>::max();
+    int last_day = std::numeric_limits<int>::min();
     for (long nLines = firstRow; nLines < lastRow; nLines++)
     {
-        const wxString& progressMsg = wxString::Format(_t("Transactions imported to account %s: %ld")
-            , "'" + acctName + "'", nImportedLines);
-        if (!progressDlg.Update(nLines - firstRow, progressMsg))
+        const unsigned int numTokens = pParser->GetItemsCount(nLines);
+        for (size_t i = 0; i < csvFieldOrder_.size() && i < numTokens; ++i)
         {
-            is_canceled = true;
-            break; // abort processing
+            if (csvFieldOrder_[i].first != UNIV_CSV_DATE)
+                continue;
+            wxDateTime date;
+            if (mmParseDisplayStringToDate(date, pParser->GetItem(nLines, i).Trim(false), date_format_))
+            {
+                const int day = ModelBase::to_day(date);
+                first_day = std::min(first_day, day);
+                last_day = std::max(last_day, day);
+            }
+        }
+    }
+    if (first_day <= last_day)
+        engine.setDuplicateWindow(first_day, last_day);
+
+    for (long nLines = firstRow; nLines < lastRow; nLines++)
+    {
+        if (engine.is_progress_due())
+        {
+            const wxString& progressMsg = wxString::Format(_t("Transactions imported to account %s: %ld")
+                , "'" + acctName + "'", nImportedLines);
+            if (!progressDlg.Update(nLines - firstRow, progressMsg))
+            {
+                is_canceled = true;
+                break; // abort processing
+            }
         }
 
         unsigned int numTokens = pParser->GetItemsCount(nLines);
@@ -1387,7 +1397,7 @@ void mmUnivCSVDialog::OnImport(wxCommandEvent& WXUNUSED(event))
                 // Store the CSV row to display in case the row is rejected
                 rowString << inQuotes(token,",") << ((i < numTokens - 1) ? "," : "");
                 if (!token.IsEmpty())
-                    parseToken(csvFieldOrder_[i].first, token, holder);
+                    parseToken(csvFieldOrder_[i].first, token, holder, engine);
                 else blankTokenCount++; // keep track of blank fields
             }
         }
@@ -1396,34 +1406,34 @@ void mmUnivCSVDialog::OnImport(wxCommandEvent& WXUNUSED(event))
         {
             wxString msg = wxString::Format(_t("Line %ld: Empty"), nLines + 1);
             log << msg << endl;
-            *log_field_ << msg << "\n";
+            logLines << msg << "\n";
             countEmptyLines++;
             continue;
         }
 
         wxString message;
         // validate data and store any error messages
-        if (!validateData(holder, message))
+        if (!validateData(holder, message, engine))
         {
             wxString msg = wxString::Format(_t("Line %ld: Error:"), nLines + 1);
             msg << " " << message;
             log << msg << endl;
-            *log_field_ << msg << "\n";
+            logLines << msg << "\n";
             // row was rejected so save it to rejectedRows
             rejectedRows << rowString << "\n";
             continue;
         }
 
         wxString trxDate = holder.Date.FormatISOCombined();
-        Model_Account::Data* account2 = Model_Account::instance().get(accountID_);
-        const Model_Account::Data* toAccount = Model_Account::instance().get(holder.ToAccountID);
+        const Model_Account::Data* account2 = engine.getAccount(accountID_);
+        const Model_Account::Data* toAccount = engine.getAccount(holder.ToAccountID);
         if ((trxDate < account2->INITIALDATE) ||
             (toAccount && (trxDate < toAccount->INITIALDATE)))
         {
             wxString msg = wxString::Format(_t("Line %ld: %s"), nLines + 1,
                 _t("The opening date for the account is later than the date of this transaction"));
             log << msg << endl;
-            *log_field_ << msg << "\n";
+            logLines << msg << "\n";
             // row was rejected so save it to rejectedRows
             rejectedRows << rowString << "\n";
             continue;
@@ -1445,39 +1455,30 @@ void mmUnivCSVDialog::OnImport(wxCommandEvent& WXUNUSED(event))
             pTransaction->NOTES.Append((pTransaction->NOTES.IsEmpty() ? "" : "\n" ) + holder.PayeeMatchNotes);
         pTransaction->COLOR = color_id;
 
-        Model_Checking::instance().save(pTransaction);
+        // flag rows that are already in the account, e.g. from an overlapping statement;
+        // a fuzzy match may be a legitimate repeat, so it keeps its status and is only reported
+        const double flow = holder.Type == Model_Checking::TYPE_NAME_DEPOSIT ? holder.Amount : -holder.Amount;
+        const auto duplicate = engine.duplicate(accountID_, ModelBase::to_day(holder.Date), flow, holder.PayeeID);
+        if (duplicate == mmImportEngine::DUPLICATE_EXACT)
+            pTransaction->STATUS = Model_Checking::STATUS_KEY_DUPLICATE;
+        if (duplicate != mmImportEngine::DUPLICATE_NONE)
+            countDuplicates++;
 
-        // save custom field data
-        if (!holder.customFieldData.empty())
-        {
-            for (const auto& field : holder.customFieldData)
-            {
-                Model_CustomFieldData::Data* cfdata = Model_CustomFieldData::instance().create();
-                cfdata->FIELDID = field.first;
-                cfdata->REFID = pTransaction->TRANSID;
-                cfdata->CONTENT = field.second;
-                Model_CustomFieldData::instance().save(cfdata);
-            }
-        }
-
-        // save tags
-        if (!holder.tagIDs.empty())
-        {
-            for (const auto& tag : holder.tagIDs)
-            {
-                Model_Taglink::Data* taglink = Model_Taglink::instance().create();
-                taglink->REFTYPE = reftype;
-                taglink->REFID = pTransaction->TRANSID;
-                taglink->TAGID = tag;
-                Model_Taglink::instance().save(taglink);
-            }
-        }
+        // saved with its custom field data and tags once the batch is full
+        engine.append(pTransaction, holder.tagIDs, holder.customFieldData);
 
         nImportedLines++;
-        wxString msg = wxString::Format(_t("Line %ld: OK, imported."), nLines + 1);
+        wxString msg = duplicate == mmImportEngine::DUPLICATE_EXACT
+            ? wxString::Format(_t("Line %ld: OK, imported as a duplicate."), nLines + 1)
+            : duplicate == mmImportEngine::DUPLICATE_FUZZY
+            ? wxString::Format(_t("Line %ld: OK, imported, possible duplicate."), nLines + 1)
+            : wxString::Format(_t("Line %ld: OK, imported."), nLines + 1);
         log << msg << endl;
-        *log_field_ << msg << "\n";
+        logLines << msg << "\n";
     }
+    engine.flush();
+    *log_field_ << logLines;
+    log << engine.throughput(linesToImport) << endl;
 
     // If any rows were rejected, display CSV rows in the log field and log file
     // so that users can easily copy/paste errored records for reimport
@@ -1496,8 +1497,12 @@ void mmUnivCSVDialog::OnImport(wxCommandEvent& WXUNUSED(event))
     msg << "\n";
     msg << wxString::Format(_t("Imported: %ld"), nImportedLines);
     msg << "\n";
+    msg << wxString::Format(_t("Possible Duplicates: %ld"), countDuplicates);
+    msg << "\n";
     msg << wxString::Format(_t("Errored: %ld")
         , linesToImport - countEmptyLines - nImportedLines);
+    msg << "\n";
+    msg << engine.throughput(linesToImport);
     msg << "\n\n";
     msg << wxString::Format(_t("Log file written to: %s"), logFile.GetFullPath());
 
@@ -1535,6 +1540,9 @@ void mmUnivCSVDialog::OnImport(wxCommandEvent& WXUNUSED(event))
     {
         // discard the database changes.
         Model_Checking::instance().Rollback("");
+        Model_Account::instance().balance_reset();
+        Model_Checking::instance().columns_reset();
+        Model_Checking::instance().autocomplete_reset();
         if (is_canceled) msg << _t("Imported transactions discarded by user!");
         else msg << _t("No imported transactions!");
         msg << "\n\n";
@@ -1747,6 +1755,7 @@ void mmUnivCSVDialog::OnExport(wxCommandEvent& WXUNUSED(event))
 void mmUnivCSVDialog::update_preview()
 {
     this->m_list_ctrl_->ClearAll();
+    m_duplicates.clear();
     m_payee_names.clear();
     m_CSVcategoryNames.clear();
     m_CSVpayeeNames.clear();
@@ -1885,7 +1894,6 @@ void mmUnivCSVDialog::update_preview()
         }
 
         m_spinIgnoreLastRows_->SetRange(m_spinIgnoreLastRows_->GetMin(), m_list_ctrl_->GetItemCount());
-        UpdateListItemBackground();
 
         if (!m_userDefinedDateMask)
         {
@@ -1899,6 +1907,8 @@ void mmUnivCSVDialog::update_preview()
             }
         }
         refreshTabs(PAYEE_TAB | CAT_TAB);
+        findDuplicates(*pImporter);
+        UpdateListItemBackground();
     }
     else // exporter preview
     {
@@ -2401,7 +2411,7 @@ void mmUnivCSVDialog::validateCategories() {
     }
 }
 
-void mmUnivCSVDialog::parseToken(int index, const wxString& orig_token, tran_holder& holder)
+void mmUnivCSVDialog::parseToken(int index, const wxString& orig_token, tran_holder& holder, mmImportEngine& engine)
 {
     if (orig_token.IsEmpty()) return;
     wxString token = orig_token.Strip(wxString::leading).Strip(wxString::trailing);
@@ -2430,11 +2440,9 @@ void mmUnivCSVDialog::parseToken(int index, const wxString& orig_token, tran_hol
         }
         else
         {
-            Model_Payee::Data* payee = Model_Payee::instance().create();
-            payee->PAYEENAME = token;
-            payee->ACTIVE = 1;
-            holder.PayeeID = Model_Payee::instance().save(payee);
-            m_CSVpayeeNames[token] = std::make_tuple(holder.PayeeID, token, wxEmptyString);
+            holder.PayeeID = engine.getPayeeID(token);
+            if (holder.PayeeID != -1)
+                m_CSVpayeeNames[token] = std::make_tuple(holder.PayeeID, token, wxEmptyString);
         }
         break;
 
@@ -2460,29 +2468,9 @@ void mmUnivCSVDialog::parseToken(int index, const wxString& orig_token, tran_hol
             holder.CategoryID = m_CSVcategoryNames[token];
         else // create category and any missing parent categories
         {
-            Model_Category::Data* category = nullptr;
-            int64 parentID = -1;
-            wxStringTokenizer tokenizer = wxStringTokenizer(token, ":");
-            while (tokenizer.HasMoreTokens())
-            {
-                wxString categname = tokenizer.GetNextToken().Trim().Trim(false);
-                category = Model_Category::instance().get(categname, parentID);
-                if (!category)
-                {
-                    category = Model_Category::instance().create();
-                    category->CATEGNAME = categname;
-                    category->PARENTID = parentID;
-                    category->ACTIVE = 1;
-                    Model_Category::instance().save(category);
-                }
-                parentID = category->CATEGID;
-            }
-
-            if (category)
-            {
-                holder.CategoryID = category->CATEGID;
-                m_CSVcategoryNames[token] = category->CATEGID;
-            }
+            holder.CategoryID = engine.getCategoryID(token);
+            if (holder.CategoryID != -1)
+                m_CSVcategoryNames[token] = holder.CategoryID;
         }
         break;
     }
@@ -2498,14 +2486,9 @@ void mmUnivCSVDialog::parseToken(int index, const wxString& orig_token, tran_hol
             holder.CategoryID = m_CSVcategoryNames[categname];
         else
         {
-            Model_Category::Data* category = Model_Category::instance().create();
-            category->PARENTID = holder.CategoryID;
-            category->CATEGNAME = token;
-            category->ACTIVE = 1;
-            Model_Category::instance().save(category);
-
-            holder.CategoryID = category->CATEGID;
-            m_CSVcategoryNames[categname] = category->CATEGID;
+            holder.CategoryID = engine.getCategoryID(token, holder.CategoryID);
+            if (holder.CategoryID != -1)
+                m_CSVcategoryNames[categname] = holder.CategoryID;
         }
         break;
     }
@@ -2515,20 +2498,11 @@ void mmUnivCSVDialog::parseToken(int index, const wxString& orig_token, tran_hol
         wxStringTokenizer tokenizer = wxStringTokenizer(token, " ");
         while (tokenizer.HasMoreTokens())
         {
-            wxString tagname = tokenizer.GetNextToken();
-            // check for an existing tag
-            Model_Tag::Data* tag = Model_Tag::instance().get(tagname);
-            if (!tag)
-            {
-                // create a new tag if we didn't find one
-                tag = Model_Tag::instance().create();
-                tag->TAGNAME = tagname;
-                tag->ACTIVE = 1;
-                Model_Tag::instance().save(tag);
-            }
+            // existing tag or a new one if we didn't find one
+            const int64 tag_id = engine.getTagID(tokenizer.GetNextToken());
             // add the tagID to the transaction if it isn't already there
-            if (std::find(holder.tagIDs.begin(), holder.tagIDs.end(), tag->TAGID) == holder.tagIDs.end())
-                holder.tagIDs.push_back(tag->TAGID);
+            if (tag_id != -1 && std::find(holder.tagIDs.begin(), holder.tagIDs.end(), tag_id) == holder.tagIDs.end())
+                holder.tagIDs.push_back(tag_id);
         }
         break;
     }
@@ -2718,10 +2692,60 @@ void mmUnivCSVDialog::UpdateListItemBackground()
     for (int row = 0; row < m_list_ctrl_->GetItemCount(); row++)
     {
         wxColour color = row >= firstRow && row <= lastRow ? m_list_ctrl_->GetBackgroundColour() : *wxLIGHT_GREY;
+        const auto duplicate = m_duplicates.find(row);
+        if (row >= firstRow && row <= lastRow && duplicate != m_duplicates.end())
+            color = duplicate->second == mmImportEngine::DUPLICATE_EXACT ? wxColour(255, 204, 204) : wxColour(255, 240, 200);
         m_list_ctrl_->SetItemBackgroundColour(row, color);
     }
 }
 
+/* Marks the preview rows that match existing transactions of the selected account.
+Rows are parsed with a read only engine, so nothing is created, and only the
+date range of the file is indexed.
+*/
+void mmUnivCSVDialog::findDuplicates(const ITransactionsFile& file)
+{
+    m_duplicates.clear();
+    const Model_Account::Data* account = Model_Account::instance().get(m_choice_account_->GetStringSelection());
+    if (!account || !isIndexPresent(UNIV_CSV_DATE) || date_format_.IsEmpty())
+        return;
+
+    m_reverce_sign = m_choiceAmountFieldSign->GetCurrentSelection() == PositiveIsWithdrawal;
+    mmImportEngine engine(1, true);
+    std::vector<std::tuple<unsigned int, int, double, int64>> rows;
+    int first_day = std::numeric_limits<int>::max();
+    int last_day = std::numeric_limits<int>::min();
+    for (unsigned int row = 0; row < file.GetLinesCount(); row++)
+    {
+        tran_holder holder;
+        const unsigned int numTokens = file.GetItemsCount(row);
+        for (size_t i = 0; i < csvFieldOrder_.size() && i < numTokens; ++i)
+        {
+            const wxString token = file.GetItem(row, i).Trim(false);
+            if (!token.IsEmpty())
+                parseToken(csvFieldOrder_[i].first, token, holder, engine);
+        }
+        if (!holder.valid || !holder.Date.IsValid() || holder.Amount == 0.0)
+            continue;
+
+        const int day = ModelBase::to_day(holder.Date);
+        const double flow = holder.Type == Model_Checking::TYPE_NAME_DEPOSIT ? holder.Amount : -holder.Amount;
+        rows.emplace_back(row, day, flow, holder.PayeeID);
+        first_day = std::min(first_day, day);
+        last_day = std::max(last_day, day);
+    }
+    if (rows.empty())
+        return;
+
+    engine.setDuplicateWindow(first_day, last_day);
+    for (const auto& [row, day, flow, payee_id] : rows)
+    {
+        const int duplicate = engine.duplicate(account->ACCOUNTID, day, flow, payee_id);
+        if (duplicate != mmImportEngine::DUPLICATE_NONE)
+            m_duplicates[row] = duplicate;
+    }
+}
+
 bool mmUnivCSVDialog::isIndexPresent(int index) const
 {
     for (std::vector<std::pair<int, int>>::const_iterator it = csvFieldOrder_.begin(); it != csvFieldOrder_.end(); ++it)
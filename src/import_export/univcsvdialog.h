@@ -33,6 +33,8 @@ class wxChoice;
 class wxTextCtrl;
 class wxStaticBox;
 class wxCheckBox;
+class mmImportEngine;
+class ITransactionsFile;
 
 #define ID_MYDIALOG8 10040
 #define SYMBOL_UNIVCSVDIALOG_STYLE wxCAPTION|wxRESIZE_BORDER|wxSYSTEM_MENU|wxCLOSE_BOX
@@ -190,6 +192,7 @@ private:
     std::map <wxString, std::tuple<int64, wxString, wxString>, caseInsensitiveComparator> m_CSVpayeeNames;
     wxArrayString m_payee_names;
     std::map <wxString, int64, caseInsensitiveComparator> m_CSVcategoryNames;
+    std::map<unsigned int, int> m_duplicates;   // preview row -> mmImportEngine::DUPLICATE_ID
     std::map<std::pair <int64, wxString>, std::map<int, std::pair<wxString, wxRegEx>> > payeeMatchPatterns_;
     bool payeeRegExInitialized_ = false;
     wxCheckBox* payeeMatchCheckBox_ = nullptr;
@@ -210,13 +213,14 @@ private:
     /// Creates the controls and sizers
     void CreateControls();
     void OnAdd(wxCommandEvent& event);
-    bool validateData(tran_holder & holder, wxString& message);
+    bool validateData(tran_holder & holder, wxString& message, mmImportEngine& engine);
     void OnImport(wxCommandEvent& event);
     void OnExport(wxCommandEvent& event);
     void OnRemove(wxCommandEvent& event);
     bool isIndexPresent(int index) const;
     const wxString getCSVFieldName(int index) const;
-    void parseToken(int index, const wxString& token, tran_holder& holder);
+    void parseToken(int index, const wxString& token, tran_holder& holder, mmImportEngine& engine);
+    void findDuplicates(const ITransactionsFile& file);
     void OnSettingsSave(wxCommandEvent& event);
     void OnMoveUp(wxCommandEvent& event);
     void OnMoveDown(wxCommandEvent& event);
@@ -21,6 +21,7 @@
 #include <wx/clipbrd.h>
 #include <wx/srchctrl.h>
 #include <algorithm>
+#include <float.h>
 #include <wx/sound.h>
 
 #include "assetdialog.h"
@@ -38,6 +39,7 @@
 #include "transactionsupdatedialog.h"
 #include "transdialog.h"
 #include "util.h"
+#include "model/Model_Category.h"
 #include "model/Model_Setting.h"
 
 //----------------------------------------------------------------------------
@@ -303,6 +305,13 @@ void TransactionListCtrl::setColumnsInfo()
     m_sort_col_id = { LIST_ID_DATE, LIST_ID_ID };
 }
 
+// Refresh after the transactions in `before` have been edited or deleted;
+// patch their rows in place if possible, otherwise rebuild the list.
+void TransactionListCtrl::patchVisualList(const Model_Checking::Data_Set& before)
+{
+    refreshVisualList(!m_cp->patchList(before));
+}
+
 int TransactionListCtrl::getSortIcon(bool asc) const
 {
     return asc ? mmCheckingPanel::ICON_DESC : mmCheckingPanel::ICON_ASC;
@@ -391,12 +400,40 @@ void TransactionListCtrl::sortList()
 template<class Compare>
 void TransactionListCtrl::sortBy(Compare comp, bool ascend)
 {
+    clearFullData();
     if (ascend)
         std::stable_sort(this->m_trans.begin(), this->m_trans.end(), comp);
     else
         std::stable_sort(this->m_trans.rbegin(), this->m_trans.rend(), comp);
 }
 
+// The sort key is not kept in TransRow: build the full data of every row
+// for the duration of the sort only
+template<class Compare>
+void TransactionListCtrl::sortByFullData(Compare comp, bool ascend)
+{
+    clearFullData();
+    std::vector<Fused_Transaction::Full_Data> full;
+    full.reserve(m_trans.size());
+    for (const auto& row : m_trans)
+        full.push_back(buildFullData(row));
+
+    std::vector<size_t> order(m_trans.size());
+    for (size_t i = 0; i < order.size(); i++)
+        order[i] = i;
+    auto order_comp = [&full, &comp](size_t x, size_t y) { return comp(full[x], full[y]); };
+    if (ascend)
+        std::stable_sort(order.begin(), order.end(), order_comp);
+    else
+        std::stable_sort(order.rbegin(), order.rend(), order_comp);
+
+    std::vector<TransRow> sorted;
+    sorted.reserve(m_trans.size());
+    for (const auto i : order)
+        sorted.push_back(m_trans[i]);
+    m_trans.swap(sorted);
+}
+
 void TransactionListCtrl::sortTransactions(int col_id, bool ascend)
 {
     const auto& ref_type = Model_Checking::refTypeName;
@@ -410,28 +447,28 @@ void TransactionListCtrl::sortTransactions(int col_id, bool ascend)
         sortBy(Fused_Transaction::SorterByFUSEDTRANSID(), ascend);
         break;
     case TransactionListCtrl::LIST_ID_NUMBER:
-        sortBy(Model_Checking::SorterByNUMBER(), ascend);
+        sortByFullData(Model_Checking::SorterByNUMBER(), ascend);
         break;
     case TransactionListCtrl::LIST_ID_ACCOUNT:
-        sortBy(SorterByACCOUNTNAME(), ascend);
+        sortByFullData(SorterByACCOUNTNAME(), ascend);
         break;
     case TransactionListCtrl::LIST_ID_PAYEE_STR:
-        sortBy(SorterByPAYEENAME(), ascend);
+        sortByFullData(SorterByPAYEENAME(), ascend);
         break;
     case TransactionListCtrl::LIST_ID_STATUS:
-        sortBy(SorterBySTATUS(), ascend);
+        sortByFullData(SorterBySTATUS(), ascend);
         break;
     case TransactionListCtrl::LIST_ID_CATEGORY:
-        sortBy(SorterByCATEGNAME(), ascend);
+        sortByFullData(SorterByCATEGNAME(), ascend);
         break;
     case TransactionListCtrl::LIST_ID_TAGS:
-        sortBy(Model_Checking::SorterByTAGNAMES(), ascend);
+        sortByFullData(Model_Checking::SorterByTAGNAMES(), ascend);
         break;
     case TransactionListCtrl::LIST_ID_WITHDRAWAL:
-        sortBy(Model_Checking::SorterByWITHDRAWAL(), ascend);
+        sortByFullData(Model_Checking::SorterByWITHDRAWAL(), ascend);
         break;
     case TransactionListCtrl::LIST_ID_DEPOSIT:
-        sortBy(Model_Checking::SorterByDEPOSIT(), ascend);
+        sortByFullData(Model_Checking::SorterByDEPOSIT(), ascend);
         break;
     case TransactionListCtrl::LIST_ID_BALANCE:
         sortBy(Model_Checking::SorterByBALANCE(), ascend);
@@ -440,7 +477,7 @@ void TransactionListCtrl::sortTransactions(int col_id, bool ascend)
         sortBy(Model_Checking::SorterByBALANCE(), ascend);
         break;
     case TransactionListCtrl::LIST_ID_NOTES:
-        sortBy(SorterByNOTES(), ascend);
+        sortByFullData(SorterByNOTES(), ascend);
         break;
     case TransactionListCtrl::LIST_ID_DATE:
         sortBy(Model_Checking::SorterByTRANSDATE_DATE(), ascend);
@@ -449,45 +486,45 @@ void TransactionListCtrl::sortTransactions(int col_id, bool ascend)
         sortBy(Model_Checking::SorterByTRANSDATE_TIME(), ascend);
         break;
     case TransactionListCtrl::LIST_ID_DELETEDTIME:
-        sortBy(SorterByDELETEDTIME(), ascend);
+        sortByFullData(SorterByDELETEDTIME(), ascend);
         break;
     case TransactionListCtrl::LIST_ID_UDFC01:
         type = Model_CustomField::getUDFCType(ref_type, "UDFC01");
         if (type == Model_CustomField::TYPE_ID_DECIMAL || type == Model_CustomField::TYPE_ID_INTEGER)
-            sortBy(SorterByUDFC01_val, ascend);
+            sortByFullData(SorterByUDFC01_val, ascend);
         else
-            sortBy(SorterByUDFC01, ascend);
+            sortByFullData(SorterByUDFC01, ascend);
         break;
     case TransactionListCtrl::LIST_ID_UDFC02:
         type = Model_CustomField::getUDFCType(ref_type, "UDFC02");
         if (type == Model_CustomField::TYPE_ID_DECIMAL || type == Model_CustomField::TYPE_ID_INTEGER)
-            sortBy(SorterByUDFC02_val, ascend);
+            sortByFullData(SorterByUDFC02_val, ascend);
         else
-            sortBy(SorterByUDFC02, ascend);
+            sortByFullData(SorterByUDFC02, ascend);
         break;
     case TransactionListCtrl::LIST_ID_UDFC03:
         type = Model_CustomField::getUDFCType(ref_type, "UDFC03");
         if (type == Model_CustomField::TYPE_ID_DECIMAL || type == Model_CustomField::TYPE_ID_INTEGER)
-            sortBy(SorterByUDFC03_val, ascend);
+            sortByFullData(SorterByUDFC03_val, ascend);
         else
-            sortBy(SorterByUDFC03, ascend);
+            sortByFullData(SorterByUDFC03, ascend);
         break;
     case TransactionListCtrl::LIST_ID_UDFC04:
         type = Model_CustomField::getUDFCType(ref_type, "UDFC04");
         if (type == Model_CustomField::TYPE_ID_DECIMAL || type == Model_CustomField::TYPE_ID_INTEGER)
-            sortBy(SorterByUDFC04_val, ascend);
+            sortByFullData(SorterByUDFC04_val, ascend);
         else
-            sortBy(SorterByUDFC04, ascend);
+            sortByFullData(SorterByUDFC04, ascend);
         break;
     case TransactionListCtrl::LIST_ID_UDFC05:
         type = Model_CustomField::getUDFCType(ref_type, "UDFC05");
         if (type == Model_CustomField::TYPE_ID_DECIMAL || type == Model_CustomField::TYPE_ID_INTEGER)
-            sortBy(SorterByUDFC05_val, ascend);
+            sortByFullData(SorterByUDFC05_val, ascend);
         else
-            sortBy(SorterByUDFC05, ascend);
+            sortByFullData(SorterByUDFC05, ascend);
         break;
     case TransactionListCtrl::LIST_ID_UPDATEDTIME:
-        sortBy(SorterByLASTUPDATEDTIME(), ascend);
+        sortByFullData(SorterByLASTUPDATEDTIME(), ascend);
         break;
     default:
         break;
@@ -532,11 +569,12 @@ wxListItemAttr* TransactionListCtrl::OnGetItemAttr(long item) const
 {
     if (item < 0 || item >= static_cast<int>(m_trans.size())) return 0;
 
-    wxString strDate = Model_Checking::TRANSDATE(m_trans[item]).FormatISOCombined();
+    const Fused_Transaction::Full_Data& fused = getFullData(item);
+    wxString strDate = Model_Checking::TRANSDATE(fused).FormatISOCombined();
     bool in_the_future = (strDate > m_today);
 
     // apply alternating background pattern
-    int user_color_id = m_trans[item].COLOR.GetValue();
+    int user_color_id = fused.COLOR.GetValue();
     if (user_color_id < 0) user_color_id = 0;
     else if (user_color_id > 7) user_color_id = 0;
 
@@ -745,51 +783,52 @@ void TransactionListCtrl::onMouseRightClick(wxMouseEvent& event)
         wxString refType = Model_Checking::refTypeName;
         wxDateTime datetime;
         wxString dateFormat = Option::instance().getDateFormat();
+        const Fused_Transaction::Full_Data& fused = getFullData(row);
 
         switch (col_id) {
         case LIST_ID_SN:
-            copyText_ = m_trans[row].displaySN;
+            copyText_ = fused.displaySN;
             break;
         case LIST_ID_ID:
-            copyText_ = m_trans[row].displayID;
+            copyText_ = fused.displayID;
             break;
         case LIST_ID_DATE: {
-            copyText_ = menuItemText = mmGetDateTimeForDisplay(m_trans[row].TRANSDATE);
-            wxString strDate = Model_Checking::TRANSDATE(m_trans[row]).FormatISODate();
+            copyText_ = menuItemText = mmGetDateTimeForDisplay(fused.TRANSDATE);
+            wxString strDate = Model_Checking::TRANSDATE(fused).FormatISODate();
             rightClickFilter_ = "{\n\"DATE1\": \"" + strDate + "\",\n\"DATE2\" : \"" + strDate + "T23:59:59" + "\"\n}";
             break;
         }
         case LIST_ID_NUMBER:
-            copyText_ = menuItemText = m_trans[row].TRANSACTIONNUMBER;
+            copyText_ = menuItemText = fused.TRANSACTIONNUMBER;
             rightClickFilter_ = "{\n\"NUMBER\": \"" + menuItemText + "\"\n}";
             break;
         case LIST_ID_ACCOUNT:
-            copyText_ = menuItemText = m_trans[row].ACCOUNTNAME;
+            copyText_ = menuItemText = fused.ACCOUNTNAME;
             rightClickFilter_ = "{\n\"ACCOUNT\": [\n\"" + menuItemText + "\"\n]\n}";
             break;
         case LIST_ID_PAYEE_STR:
-            copyText_ = m_trans[row].PAYEENAME;
-            if (!Model_Checking::is_transfer(m_trans[row].TRANSCODE)) {
-                menuItemText = m_trans[row].PAYEENAME;
+            copyText_ = fused.PAYEENAME;
+            if (!Model_Checking::is_transfer(fused.TRANSCODE)) {
+                menuItemText = fused.PAYEENAME;
                 rightClickFilter_ = "{\n\"PAYEE\": \"" + menuItemText + "\"\n}";
             }
             break;
         case LIST_ID_STATUS:
-            copyText_ = menuItemText = Model_Checking::status_name(m_trans[row].STATUS);
+            copyText_ = menuItemText = Model_Checking::status_name(fused.STATUS);
             rightClickFilter_ = "{\n\"STATUS\": \"" + menuItemText + "\"\n}";
             break;
         case LIST_ID_CATEGORY:
-            copyText_ = m_trans[row].CATEGNAME;
-            if (!m_trans[row].has_split()) {
-                menuItemText = m_trans[row].CATEGNAME;
+            copyText_ = fused.CATEGNAME;
+            if (!fused.has_split()) {
+                menuItemText = fused.CATEGNAME;
                 rightClickFilter_ = "{\n\"CATEGORY\": \"" + menuItemText + "\",\n\"SUBCATEGORYINCLUDE\": false\n}";
             }
             break;
         case LIST_ID_TAGS:
-            if (!m_trans[row].has_split() && m_trans[row].has_tags()) {
-                copyText_ = menuItemText = m_trans[row].TAGNAMES;
+            if (!fused.has_split() && fused.has_tags()) {
+                copyText_ = menuItemText = fused.TAGNAMES;
                 // build the tag filter json
-                for (const auto& tag : m_trans[row].m_tags) {
+                for (const auto& tag : fused.m_tags) {
                     rightClickFilter_ += (rightClickFilter_.IsEmpty() ? "{\n\"TAGS\": [\n" : ",\n") + wxString::Format("%lld", tag.TAGID);
                 }
                 rightClickFilter_ += "\n]\n}";
@@ -797,67 +836,67 @@ void TransactionListCtrl::onMouseRightClick(wxMouseEvent& event)
             break;
         case LIST_ID_WITHDRAWAL: {
             columnIsAmount = true;
-            Model_Account::Data* account = Model_Account::instance().get(m_trans[row].ACCOUNTID_W);
+            Model_Account::Data* account = Model_Account::instance().get(fused.ACCOUNTID_W);
             Model_Currency::Data* currency = account ? Model_Currency::instance().get(account->CURRENCYID) : nullptr;
             if (currency) {
-                copyText_ = Model_Currency::toString(m_trans[row].TRANSAMOUNT_W, currency);
-                menuItemText = wxString::Format("%.2f", m_trans[row].TRANSAMOUNT_W);
+                copyText_ = Model_Currency::toString(fused.TRANSAMOUNT_W, currency);
+                menuItemText = wxString::Format("%.2f", fused.TRANSAMOUNT_W);
                 rightClickFilter_ = "{\n\"AMOUNT_MIN\": " + menuItemText + ",\n\"AMOUNT_MAX\" : " + menuItemText + "\n}";
             }
             break;
         }
         case LIST_ID_DEPOSIT: {
             columnIsAmount = true;
-            Model_Account::Data* account = Model_Account::instance().get(m_trans[row].ACCOUNTID_D);
+            Model_Account::Data* account = Model_Account::instance().get(fused.ACCOUNTID_D);
             Model_Currency::Data* currency = account ? Model_Currency::instance().get(account->CURRENCYID) : nullptr;
             if (currency) {
-                copyText_ = Model_Currency::toString(m_trans[row].TRANSAMOUNT_D, currency);
-                menuItemText = wxString::Format("%.2f", m_trans[row].TRANSAMOUNT_D);
+                copyText_ = Model_Currency::toString(fused.TRANSAMOUNT_D, currency);
+                menuItemText = wxString::Format("%.2f", fused.TRANSAMOUNT_D);
                 rightClickFilter_ = "{\n\"AMOUNT_MIN\": " + menuItemText + ",\n\"AMOUNT_MAX\" : " + menuItemText + "\n}";
             }
             break;
         }
         case LIST_ID_BALANCE:
-            copyText_ = Model_Currency::toString(m_trans[row].ACCOUNT_BALANCE, m_cp->m_currency);
+            copyText_ = Model_Currency::toString(fused.ACCOUNT_BALANCE, m_cp->m_currency);
             break;
         case LIST_ID_CREDIT:
             copyText_ = Model_Currency::toString(
-                m_cp->m_account->CREDITLIMIT + m_trans[row].ACCOUNT_BALANCE,
+                m_cp->m_account->CREDITLIMIT + fused.ACCOUNT_BALANCE,
                 m_cp->m_currency
             );
             break;
         case LIST_ID_NOTES:
-            copyText_ = menuItemText = m_trans[row].NOTES;
+            copyText_ = menuItemText = fused.NOTES;
             rightClickFilter_ = "{\n\"NOTES\": \"" + menuItemText + "\"\n}";
             break;
         case LIST_ID_DELETEDTIME:
-            datetime.ParseISOCombined(m_trans[row].DELETEDTIME);
+            datetime.ParseISOCombined(fused.DELETEDTIME);
             if(datetime.IsValid())
                 copyText_ = mmGetDateTimeForDisplay(datetime.FromUTC().FormatISOCombined(), dateFormat + " %H:%M:%S");
             break;
         case LIST_ID_UPDATEDTIME:
-            datetime.ParseISOCombined(m_trans[row].LASTUPDATEDTIME);
+            datetime.ParseISOCombined(fused.LASTUPDATEDTIME);
             if (datetime.IsValid())
                 copyText_ = mmGetDateTimeForDisplay(datetime.FromUTC().FormatISOCombined(), dateFormat + " %H:%M:%S");
             break;
         case LIST_ID_UDFC01:
-            copyText_ = menuItemText = m_trans[row].UDFC_content[0];
+            copyText_ = menuItemText = fused.UDFC_content[0];
             rightClickFilter_ = wxString::Format("{\n\"CUSTOM%lld\": \"" + menuItemText + "\"\n}", Model_CustomField::getUDFCID(refType, "UDFC01"));
             break;
         case LIST_ID_UDFC02:
-            copyText_ = menuItemText = m_trans[row].UDFC_content[1];
+            copyText_ = menuItemText = fused.UDFC_content[1];
             rightClickFilter_ = wxString::Format("{\n\"CUSTOM%lld\": \"" + menuItemText + "\"\n}", Model_CustomField::getUDFCID(refType, "UDFC02"));
             break;
         case LIST_ID_UDFC03:
-            copyText_ = menuItemText = m_trans[row].UDFC_content[2];
+            copyText_ = menuItemText = fused.UDFC_content[2];
             rightClickFilter_ = wxString::Format("{\n\"CUSTOM%lld\": \"" + menuItemText + "\"\n}", Model_CustomField::getUDFCID(refType, "UDFC03"));
             break;
         case LIST_ID_UDFC04:
-            copyText_ = menuItemText = m_trans[row].UDFC_content[3];
+            copyText_ = menuItemText = fused.UDFC_content[3];
             rightClickFilter_ = wxString::Format("{\n\"CUSTOM%lld\": \"" + menuItemText + "\"\n}", Model_CustomField::getUDFCID(refType, "UDFC04"));
             break;
         case LIST_ID_UDFC05:
-            copyText_ = menuItemText = m_trans[row].UDFC_content[4];
+            copyText_ = menuItemText = fused.UDFC_content[4];
             rightClickFilter_ = wxString::Format("{\n\"CUSTOM%lld\": \"" + menuItemText + "\"\n}", Model_CustomField::getUDFCID(refType, "UDFC05"));
             break;
         default:
@@ -1096,6 +1135,7 @@ void TransactionListCtrl::onDeleteTransaction(wxCommandEvent& WXUNUSED(event))
     if (msgDlg.ShowModal() == wxID_YES) {
         wxString deletionTime = wxDateTime::Now().ToUTC().FormatISOCombined();
         std::set<std::pair<wxString, int64>> assetStockAccts;
+        Model_Checking::Data_Set before;
         Model_Checking::instance().Savepoint();
         Model_Attachment::instance().Savepoint();
         Model_Splittransaction::instance().Savepoint();
@@ -1107,6 +1147,7 @@ void TransactionListCtrl::onDeleteTransaction(wxCommandEvent& WXUNUSED(event))
             if (checkTransactionLocked(trx->ACCOUNTID, trx->TRANSDATE)) {
                 continue;
             }
+            before.push_back(*trx);
 
             if (m_cp->isDeletedTrans() || retainDays == 0) {
                 // remove also removes split transactions, translink entries, attachments, and custom field data
@@ -1135,8 +1176,10 @@ void TransactionListCtrl::onDeleteTransaction(wxCommandEvent& WXUNUSED(event))
                 else if (i.first == "Stock") Model_Stock::UpdatePosition(Model_Stock::instance().get(i.second));
             }
         }
+        patchVisualList(before);
     }
-    refreshVisualList();
+    else
+        refreshVisualList();
     m_cp->m_frame->RefreshNavigationTree();
 }
 
@@ -1244,9 +1287,12 @@ void TransactionListCtrl::onEditTransaction(wxCommandEvent& /*event*/)
                 transid.push_back(id.first);
         if (transid.size() == 0) return;
         if (!checkForClosedAccounts()) return;
+        Model_Checking::Data_Set before;
+        for (const auto& i : transid)
+            before.push_back(*Model_Checking::instance().get(i));
         transactionsUpdateDialog dlg(this, transid);
         if (dlg.ShowModal() == wxID_OK)
-            refreshVisualList();
+            patchVisualList(before);
         return;
     }
 
@@ -1274,9 +1320,10 @@ void TransactionListCtrl::onEditTransaction(wxCommandEvent& /*event*/)
             }
         }
         else {
+            Model_Checking::Data_Set before = { *checking_entry };
             mmTransDialog dlg(this, m_cp->m_account_id, {id.first, false});
             if (dlg.ShowModal() != wxID_CANCEL)
-                refreshVisualList();
+                patchVisualList(before);
         }
     }
     else {
@@ -1467,16 +1514,22 @@ void TransactionListCtrl::onMarkTransaction(wxCommandEvent& event)
 
     for (int row = 0; row < GetItemCount(); row++) {
         if (GetItemState(row, wxLIST_STATE_SELECTED) == wxLIST_STATE_SELECTED) {
-            Model_Account::Data* account = Model_Account::instance().get(m_trans[row].ACCOUNTID);
+            if (isRecordGone(m_trans[row]))
+                continue;
+            const Fused_Transaction::Full_Data& fused = getFullData(row);
+            Model_Account::Data* account = Model_Account::instance().get(fused.ACCOUNTID);
+            if (!account)
+                continue;
             const auto statement_date = Model_Account::DateOf(account->STATEMENTDATE).FormatISODate();
-            wxString strDate = Model_Checking::TRANSDATE(m_trans[row]).FormatISODate();
+            wxString strDate = Model_Checking::TRANSDATE(fused).FormatISODate();
             if (!Model_Account::BoolOf(account->STATEMENTLOCKED)
                 || strDate > statement_date
             ) {
-                //bRefreshRequired |= (status == Model_Checking::STATUS_KEY_VOID) || (m_trans[row].STATUS == Model_Checking::STATUS_KEY_VOID);
-                if (!m_trans[row].m_repeat_num) {
-                    m_trans[row].STATUS = status;
-                    Model_Checking::instance().save(&m_trans[row]);
+                //bRefreshRequired |= (status == Model_Checking::STATUS_KEY_VOID) || (fused.STATUS == Model_Checking::STATUS_KEY_VOID);
+                if (!fused.m_repeat_num) {
+                    Model_Checking::Data* trx = Model_Checking::instance().get(fused.TRANSID);
+                    trx->STATUS = status;
+                    Model_Checking::instance().save(trx);
                 }
             }
         }
@@ -1542,6 +1595,8 @@ void TransactionListCtrl::onSelectAll(wxCommandEvent& WXUNUSED(event))
     for (int row = 0; row < GetItemCount(); row++) {
         SetItemState(row, wxLIST_STATE_SELECTED, wxLIST_STATE_SELECTED);
         const auto& tran = m_trans[row];
+        if (isRecordGone(tran))
+            continue;
         Fused_Transaction::IdRepeat id = { !tran.m_repeat_num ? tran.TRANSID : tran.m_bdid, tran.m_repeat_num };
         if (unique_ids.find(id) == unique_ids.end()) {
             m_selected_id.push_back(id);
@@ -1791,7 +1846,7 @@ const wxString TransactionListCtrl::getItem(long item, int col_id) const
     // TODO: add isHiddenColId(col_id)
     if (isDisabledColId(col_id))
         return "";
-    const Fused_Transaction::Full_Data& fused = m_trans.at(item);
+    const Fused_Transaction::Full_Data& fused = getFullData(item);
 
     wxString value = wxEmptyString;
     wxDateTime datetime;
@@ -1906,6 +1961,128 @@ const wxString TransactionListCtrl::getItem(long item, int col_id) const
     return value;
 }
 
+const Fused_Transaction::Full_Data& TransactionListCtrl::getFullData(long item) const
+{
+    auto it = m_full_cache_index.find(item);
+    if (it != m_full_cache_index.end()) {
+        m_full_cache.splice(m_full_cache.begin(), m_full_cache, it->second);
+        return it->second->second;
+    }
+
+    if (m_full_cache.size() >= FULL_DATA_CACHE_SIZE) {
+        m_full_cache_index.erase(m_full_cache.back().first);
+        m_full_cache.pop_back();
+    }
+    m_full_cache.emplace_front(item, buildFullData(m_trans.at(item)));
+    m_full_cache_index[item] = m_full_cache.begin();
+    return m_full_cache.front().second;
+}
+
+void TransactionListCtrl::clearFullData()
+{
+    m_full_cache.clear();
+    m_full_cache_index.clear();
+}
+
+bool TransactionListCtrl::isRecordGone(const TransRow& row) const
+{
+    // get() hands out a blank record for an id that is gone
+    if (row.m_repeat_num == 0) {
+        const Model_Checking::Data* tran = Model_Checking::instance().get(row.TRANSID);
+        return !tran || tran->TRANSID != row.TRANSID;
+    }
+    const Model_Billsdeposits::Data* bill = Model_Billsdeposits::instance().get(row.m_bdid);
+    return !bill || bill->BDID != row.m_bdid;
+}
+
+Fused_Transaction::Full_Data TransactionListCtrl::buildFullData(const TransRow& row) const
+{
+    const wxString tranSplitRefType = Model_Splittransaction::refTypeName;
+    const wxString billSplitRefType = Model_Budgetsplittransaction::refTypeName;
+
+    if (isRecordGone(row)) {
+        // the list is rebuilt on the next refresh
+        return Fused_Transaction::Full_Data(Model_Checking::Data());
+    }
+    const Model_Checking::Data* tran = nullptr;
+    const Model_Billsdeposits::Data* bill = nullptr;
+    if (row.m_repeat_num == 0)
+        tran = Model_Checking::instance().get(row.TRANSID);
+    else
+        bill = Model_Billsdeposits::instance().get(row.m_bdid);
+
+    Fused_Transaction::Full_Data full_tran = tran ?
+        Fused_Transaction::Full_Data(*tran, m_cp->m_trans_splits, m_cp->m_trans_tags) :
+        Fused_Transaction::Full_Data(*bill, row.TRANSDATE, row.m_repeat_num, m_cp->m_bills_splits, m_cp->m_bills_tags);
+
+    full_tran.PAYEENAME = full_tran.real_payee_name(m_cp->m_account_id);
+    if (m_cp->isAccount()) {
+        if (full_tran.ACCOUNTID_W != m_cp->m_account_id) {
+            full_tran.ACCOUNTID_W = -1; full_tran.TRANSAMOUNT_W = 0.0;
+        }
+        if (full_tran.ACCOUNTID_D != m_cp->m_account_id) {
+            full_tran.ACCOUNTID_D = -1; full_tran.TRANSAMOUNT_D = 0.0;
+        }
+        full_tran.ACCOUNT_FLOW = row.ACCOUNT_FLOW;
+        full_tran.ACCOUNT_BALANCE = row.ACCOUNT_BALANCE;
+    }
+
+    const auto& attachments = tran ? m_cp->m_trans_attachments : m_cp->m_bills_attachments;
+    const auto attachment_it = attachments.find(tran ? row.TRANSID : row.m_bdid);
+    if (attachment_it != attachments.end()) {
+        for (const auto& entry : attachment_it->second)
+            full_tran.ATTACHMENT_DESCRIPTION.Add(entry.DESCRIPTION);
+    }
+
+    for (int i = 0; i < 5; i++) {
+        full_tran.UDFC_type[i] = Model_CustomField::TYPE_ID_UNKNOWN;
+        full_tran.UDFC_value[i] = -DBL_MAX;
+    }
+
+    // custom data of a scheduled transaction is stored with negative BDID
+    const auto field_it = m_cp->m_trans_fields.find(tran ? row.TRANSID : -row.m_bdid);
+    if (field_it != m_cp->m_trans_fields.end()) {
+        for (const auto& udfc : field_it->second) {
+            for (int i = 0; i < 5; i++) {
+                if (udfc.FIELDID == m_cp->m_udfc_id[i]) {
+                    full_tran.UDFC_type[i] = m_cp->m_udfc_type[i];
+                    full_tran.UDFC_content[i] = udfc.CONTENT;
+                    full_tran.UDFC_value[i] = cleanseNumberStringToDouble(
+                        udfc.CONTENT, m_cp->m_udfc_scale[i] > 0
+                    );
+                    break;
+                }
+            }
+        }
+    }
+
+    wxString marker = (row.m_repeat_num == 0) ? "" : "*";
+    full_tran.SN = row.SN;
+    full_tran.displaySN = wxString::Format("%s%ld", marker, full_tran.SN);
+    if (row.m_repeat_num > 0)
+        full_tran.displayID = wxString::Format("%s%lld", marker, full_tran.m_bdid);
+
+    if (row.m_split_pos < 0 || row.m_split_pos >= static_cast<int>(full_tran.m_splits.size()))
+        return full_tran;
+
+    // expanded row: show a single split of the transaction
+    const auto split = full_tran.m_splits[row.m_split_pos];
+    full_tran.displaySN += "." + wxString::Format("%i", row.m_split_num);
+    full_tran.displayID += "." + wxString::Format("%i", row.m_split_num);
+    full_tran.CATEGID = split.CATEGID;
+    full_tran.CATEGNAME = Model_Category::full_name(split.CATEGID);
+    full_tran.TRANSAMOUNT = split.SPLITTRANSAMOUNT;
+    full_tran.NOTES.Append((full_tran.NOTES.IsEmpty() ? "" : " ") + split.NOTES);
+    wxString tagnames;
+    const wxString reftype = (row.m_repeat_num == 0) ? tranSplitRefType : billSplitRefType;
+    for (const auto& tag : Model_Taglink::instance().get(reftype, split.SPLITTRANSID))
+        tagnames.Append(tag.first + " ");
+    if (!tagnames.IsEmpty())
+        full_tran.TAGNAMES.Append((full_tran.TAGNAMES.IsEmpty() ? "" : ", ") + tagnames.Trim());
+
+    return full_tran;
+}
+
 void TransactionListCtrl::setExtraTransactionData(const bool single)
 {
     int repeat_num = 0;
@@ -1958,6 +2135,8 @@ void TransactionListCtrl::findSelectedTransactions()
     for (const auto& tran : m_trans) {
         if (GetItemState(x++, wxLIST_STATE_SELECTED) != wxLIST_STATE_SELECTED)
             continue;
+        if (isRecordGone(tran))
+            continue;
         int64 id = !tran.m_repeat_num ? tran.TRANSID : tran.m_bdid;
         if (unique_ids.find({id, tran.m_repeat_num}) == unique_ids.end()) {
             m_selected_id.push_back({id, tran.m_repeat_num});
@@ -2008,8 +2187,8 @@ void TransactionListCtrl::doSearchText(const wxString& value)
         double v;
         if (test1.ToCDouble(&v)) {
             try {
-                double amount = m_trans.at(selectedItem).TRANSAMOUNT;
-                double to_trans_amount = m_trans.at(selectedItem).TOTRANSAMOUNT;
+                double amount = getFullData(selectedItem).TRANSAMOUNT;
+                double to_trans_amount = getFullData(selectedItem).TOTRANSAMOUNT;
                 if (v == amount || v == to_trans_amount) {
                     return markItem(selectedItem);
                 }
@@ -2033,7 +2212,7 @@ void TransactionListCtrl::doSearchText(const wxString& value)
             }
         }
 
-        for (const auto& entry : m_trans.at(selectedItem).ATTACHMENT_DESCRIPTION) {
+        for (const auto& entry : getFullData(selectedItem).ATTACHMENT_DESCRIPTION) {
             wxString test = entry.Lower();
             if (test.Matches(pattern)) {
                 return markItem(selectedItem);
@@ -2091,15 +2270,18 @@ void TransactionListCtrl::deleteTransactionsByStatus(const wxString& status)
     Model_Attachment::instance().Savepoint();
     Model_Splittransaction::instance().Savepoint();
     Model_CustomFieldData::instance().Savepoint();
-    for (const auto& tran : this->m_trans) {
-        if (tran.m_repeat_num) continue;
-        if (tran.STATUS == s || (s.empty() && status.empty())) {
+    for (const auto& row : this->m_trans) {
+        if (row.m_repeat_num) continue;
+        const Model_Checking::Data* tran = Model_Checking::instance().get(row.TRANSID);
+        // get() hands out a blank record for an id that is gone
+        if (!tran || tran->TRANSID != row.TRANSID) continue;
+        if (tran->STATUS == s || (s.empty() && status.empty())) {
             if (m_cp->isDeletedTrans() || retainDays == 0) {
                 // remove also removes any split transactions, translink entries, attachments, and custom field data
-                Model_Checking::instance().remove(tran.TRANSID);
+                Model_Checking::instance().remove(row.TRANSID);
             }
             else {
-                Model_Checking::Data* trx = Model_Checking::instance().get(tran.TRANSID);
+                Model_Checking::Data* trx = Model_Checking::instance().get(row.TRANSID);
                 trx->DELETEDTIME = deletionTime;
                 Model_Checking::instance().save(trx);
                 Model_Translink::Data_Set translink = Model_Translink::instance().find(Model_Translink::CHECKINGACCOUNTID(trx->TRANSID));
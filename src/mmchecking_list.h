@@ -25,6 +25,8 @@ Copyright (C) 2021-2024 Mark Whalley (mark@ipx.co.uk)
 #include "mmpanelbase.h"
 #include "mmcheckingpanel.h"
 #include "fusedtransaction.h"
+#include <list>
+#include <unordered_map>
 
 class mmCheckingPanel;
 
@@ -123,7 +125,26 @@ private:
     };
 
 private:
-    Fused_Transaction::Full_Data_Set m_trans;
+    // compact row of the list, built by mmCheckingPanel::filterList();
+    // the full data of a row is built on demand by getFullData()
+    struct TransRow
+    {
+        int64 TRANSID = 0;      // 0 for a scheduled transaction
+        int64 m_bdid = 0;
+        int m_repeat_num = 0;
+        int m_split_pos = -1;   // position in m_splits of the split shown by an expanded row
+        int m_split_num = 0;    // number of that split in displaySN/displayID
+        long SN = 0;
+        wxString TRANSDATE;
+        double ACCOUNT_FLOW = 0.0;
+        double ACCOUNT_BALANCE = 0.0;
+    };
+    static const size_t FULL_DATA_CACHE_SIZE = 512;
+
+    std::vector<TransRow> m_trans;
+    // least recently used full data, keyed by row number
+    mutable std::list<std::pair<long, Fused_Transaction::Full_Data> > m_full_cache;
+    mutable std::unordered_map<long, decltype(m_full_cache)::iterator> m_full_cache_index;
     long m_topItemIndex = -1; // where to display the list again after refresh
     wxString m_today;
     bool m_firstSort = true;
@@ -151,9 +172,12 @@ private:
 private:
     void setColumnsInfo();
     void refreshVisualList(bool filter = true);
+    void patchVisualList(const Model_Checking::Data_Set& before);
     void sortList();
     template<class Compare>
     void sortBy(Compare comp, bool ascend);
+    template<class Compare>
+    void sortByFullData(Compare comp, bool ascend);
     void sortTransactions(int col_id, bool ascend);
 
 private:
@@ -204,6 +228,11 @@ private:
 
 private:
     const wxString getItem(long item, int col_id) const;
+    const Fused_Transaction::Full_Data& getFullData(long item) const;
+    Fused_Transaction::Full_Data buildFullData(const TransRow& row) const;
+    // true when the record of the row was removed outside this list
+    bool isRecordGone(const TransRow& row) const;
+    void clearFullData();
     void setExtraTransactionData(const bool single);
     void markItem(long selectedItem);
     void setSelectedId(Fused_Transaction::IdRepeat sel_id);
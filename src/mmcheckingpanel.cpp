@@ -578,7 +578,9 @@ void mmCheckingPanel::refreshList()
 
 void mmCheckingPanel::filterList()
 {
+    countRefresh(REFRESH_ID_FULL);
     m_lc->m_trans.clear();
+    m_lc->clearFullData();
 
     wxString date_start_str = m_date_range.checking_start_str();
     wxString date_end_str = m_date_range.checking_end_str();
@@ -588,27 +590,26 @@ void mmCheckingPanel::filterList()
     m_balance = m_account ? m_account->INITIALBAL : 0.0;
     m_reconciled_balance = m_balance;
     m_show_reconciled = false;
+    m_unreconciled_count = 0;
 
     const wxString tranRefType = Model_Checking::refTypeName;
     const wxString billRefType = Model_Billsdeposits::refTypeName;
-    const wxString tranSplitRefType = Model_Splittransaction::refTypeName;
-    const wxString billSplitRefType = Model_Budgetsplittransaction::refTypeName;
 
     static wxArrayString udfc_fields = Model_CustomField::UDFC_FIELDS();
-    int64 udfc_id[5];
-    Model_CustomField::TYPE_ID udfc_type[5];
-    int udfc_scale[5];
     for (int i = 0; i < 5; i++) {
         // note: udfc_fields starts with ""
         wxString field = udfc_fields[i+1];
-        udfc_id[i] = Model_CustomField::getUDFCID(tranRefType, field);
-        udfc_type[i] = Model_CustomField::getUDFCType(tranRefType, field);
-        udfc_scale[i] = Model_CustomField::getDigitScale(
+        m_udfc_id[i] = Model_CustomField::getUDFCID(tranRefType, field);
+        m_udfc_type[i] = Model_CustomField::getUDFCType(tranRefType, field);
+        m_udfc_scale[i] = Model_CustomField::getDigitScale(
             Model_CustomField::getUDFCProperties(tranRefType, field)
         );
     }
 
-    auto tranFieldData = Model_CustomFieldData::instance().get_all(Model_Checking::refTypeName);
+    m_trans_fields = Model_CustomFieldData::instance().get_all(Model_Checking::refTypeName);
+
+    if (m_filter_id == FILTER_ID_ADVANCED)
+        m_trans_filter_dlg->mmCompileFilter();
 
     bool ignore_future = Option::instance().getIgnoreFutureTransactions();
     const wxString today_date = Option::instance().UseTransDateTime() ?
@@ -618,13 +619,13 @@ void mmCheckingPanel::filterList()
     const auto trans = m_account ?
         Model_Account::transactionsByDateTimeId(m_account) :
         Model_Checking::instance().allByDateTimeId();
-    const auto trans_splits = Model_Splittransaction::instance().get_all();
-    const auto trans_tags = Model_Taglink::instance().get_all(tranRefType);
-    const auto trans_attachments = Model_Attachment::instance().get_all(Model_Checking::refTypeName);
+    m_trans_splits = Model_Splittransaction::instance().get_all();
+    m_trans_tags = Model_Taglink::instance().get_all(tranRefType);
+    m_trans_attachments = Model_Attachment::instance().get_all(Model_Checking::refTypeName);
 
-    std::map<int64, Model_Budgetsplittransaction::Data_Set> bills_splits;
-    std::map<int64, Model_Taglink::Data_Set> bills_tags;
-    std::map<int64, Model_Attachment::Data_Set> bills_attachments;
+    m_bills_splits.clear();
+    m_bills_tags.clear();
+    m_bills_attachments.clear();
     Model_Billsdeposits::Data_Set bills;
     typedef std::tuple<
         int /* i */,
@@ -633,9 +634,9 @@ void mmCheckingPanel::filterList()
     > bills_index_t;
     std::vector<bills_index_t> bills_index;
     if (m_scheduled_enable && m_scheduled_selected) {
-        bills_splits = Model_Budgetsplittransaction::instance().get_all();
-        bills_tags = Model_Taglink::instance().get_all(billRefType);
-        bills_attachments = Model_Attachment::instance().get_all(Model_Billsdeposits::refTypeName);
+        m_bills_splits = Model_Budgetsplittransaction::instance().get_all();
+        m_bills_tags = Model_Taglink::instance().get_all(billRefType);
+        m_bills_attachments = Model_Attachment::instance().get_all(Model_Billsdeposits::refTypeName);
         bills = m_account ?
             Model_Account::billsdeposits(m_account) :
             Model_Billsdeposits::instance().all();
@@ -697,113 +698,66 @@ void mmCheckingPanel::filterList()
             m_balance += account_flow;
             if (Model_Checking::status_id(tran->STATUS) == Model_Checking::STATUS_ID_RECONCILED)
                 m_reconciled_balance += account_flow;
-            else
+            else {
                 m_show_reconciled = true;
+                m_unreconciled_count++;
+            }
         }
 
         if (tran_date < date_start_str || tran_date > date_end_str)
             continue;
 
-        Fused_Transaction::Full_Data full_tran = (repeat_num == 0) ?
-            Fused_Transaction::Full_Data(*tran, trans_splits, trans_tags) :
-            Fused_Transaction::Full_Data(bills[bill_i], tran_date, repeat_num, bills_splits, bills_tags);
+        TransactionListCtrl::TransRow row;
+        row.TRANSID = tran->TRANSID;
+        row.m_bdid = (repeat_num == 0) ? 0 : bills[bill_i].BDID;
+        row.m_repeat_num = repeat_num;
+        row.TRANSDATE = tran->TRANSDATE;
 
+        // only the advanced filter needs the splits here
         bool expandSplits = false;
+        Fused_Transaction::Split_Data_Set splits;
         if (m_filter_id == FILTER_ID_ADVANCED) {
-            int txnMatch = m_trans_filter_dlg->mmIsRecordMatches(*tran, full_tran.m_splits);
+            if (repeat_num == 0) {
+                const auto it = m_trans_splits.find(row.TRANSID);
+                if (it != m_trans_splits.end()) splits = it->second;
+            }
+            else {
+                const auto it = m_bills_splits.find(row.m_bdid);
+                if (it != m_bills_splits.end()) splits = Fused_Transaction::execute_splits(it->second);
+            }
+            int txnMatch = m_trans_filter_dlg->mmIsRecordMatches(*tran, splits);
             if (!txnMatch)
                 continue;
-            if (txnMatch < static_cast<int>(full_tran.m_splits.size()) + 1)
+            if (txnMatch < static_cast<int>(splits.size()) + 1)
                 expandSplits = true;
         }
 
-        full_tran.PAYEENAME = full_tran.real_payee_name(m_account_id);
         if (isAccount()) {
-            if (full_tran.ACCOUNTID_W != m_account_id) {
-                full_tran.ACCOUNTID_W = -1; full_tran.TRANSAMOUNT_W = 0.0;
-            }
-            if (full_tran.ACCOUNTID_D != m_account_id) {
-                full_tran.ACCOUNTID_D = -1; full_tran.TRANSAMOUNT_D = 0.0;
-            }
-            full_tran.ACCOUNT_FLOW = account_flow;
-            full_tran.ACCOUNT_BALANCE = m_balance;
+            row.ACCOUNT_FLOW = account_flow;
+            row.ACCOUNT_BALANCE = m_balance;
         }
-
-        if (repeat_num == 0 && trans_attachments.find(tran->TRANSID) != trans_attachments.end()) {
-            for (const auto& entry : trans_attachments.at(tran->TRANSID))
-                full_tran.ATTACHMENT_DESCRIPTION.Add(entry.DESCRIPTION);
-        }
-        else if (repeat_num > 0 && bills_attachments.find(full_tran.m_bdid) != bills_attachments.end()) {
-            for (const auto& entry : bills_attachments.at(full_tran.m_bdid))
-                full_tran.ATTACHMENT_DESCRIPTION.Add(entry.DESCRIPTION);
-        }
-
-        for (int i = 0; i < 5; i++) {
-            full_tran.UDFC_type[i] = Model_CustomField::TYPE_ID_UNKNOWN;
-            full_tran.UDFC_value[i] = -DBL_MAX;
-        }
-
-        if (repeat_num == 0 && tranFieldData.find(tran->TRANSID) != tranFieldData.end()) {
-            for (const auto& udfc : tranFieldData.at(tran->TRANSID)) {
-                for (int i = 0; i < 5; i++) {
-                    if (udfc.FIELDID == udfc_id[i]) {
-                        full_tran.UDFC_type[i] = udfc_type[i];
-                        full_tran.UDFC_content[i] = udfc.CONTENT;
-                        full_tran.UDFC_value[i] = cleanseNumberStringToDouble(
-                            udfc.CONTENT, udfc_scale[i] > 0
-                        );
-                        break;
-                    }
-                }
-            }
-        }
-        else if (repeat_num > 0 && tranFieldData.find(-full_tran.m_bdid) != tranFieldData.end()) {
-            for (const auto& udfc : tranFieldData.at(-full_tran.m_bdid)) {
-                for (int i = 0; i < 5; i++) {
-                    if (udfc.FIELDID == udfc_id[i]) {
-                        full_tran.UDFC_type[i] = udfc_type[i];
-                        full_tran.UDFC_content[i] = udfc.CONTENT;
-                        full_tran.UDFC_value[i] = cleanseNumberStringToDouble(
-                            udfc.CONTENT, udfc_scale[i] > 0
-                        );
-                        break;
-                    }
-                }
-            }
-        }
-
-        wxString marker = (repeat_num == 0) ? "" : "*";
-        full_tran.SN = ++sn;
-        full_tran.displaySN = wxString::Format("%s%ld", marker, full_tran.SN);
-        if (repeat_num > 0)
-            full_tran.displayID = wxString::Format("%s%ld", marker, full_tran.m_bdid);
+        row.SN = ++sn;
 
         if (!expandSplits) {
-            m_lc->m_trans.push_back(full_tran);
+            m_lc->m_trans.push_back(row);
             if (isAccount())
                 m_flow += account_flow;
             continue;
         }
         // else {
         // assertion: m_filter_id == FILTER_ID_ADVANCED
-        // assertion: Model_Checking::is_transfer(full_tran.TRANSCODE) == false
+        // assertion: Model_Checking::is_transfer(tran->TRANSCODE) == false
         int splitIndex = 1;
-        wxString tranTagnames = full_tran.TAGNAMES;
-        wxString tranDisplaySN = full_tran.displaySN;
-        wxString tranDisplayID = full_tran.displayID;
-        for (const auto& split : full_tran.m_splits) {
+        for (int pos = 0; pos < static_cast<int>(splits.size()); pos++) {
+            const auto& split = splits[pos];
             if (!m_trans_filter_dlg->mmIsSplitRecordMatches<Model_Splittransaction>(split))
                 continue;
-            full_tran.displaySN = tranDisplaySN + "." + wxString::Format("%i", splitIndex);
-            full_tran.displayID = tranDisplayID + "." + wxString::Format("%i", splitIndex);
-            splitIndex++;
-            full_tran.CATEGID = split.CATEGID;
-            full_tran.CATEGNAME = Model_Category::full_name(split.CATEGID);
-            full_tran.TRANSAMOUNT = split.SPLITTRANSAMOUNT;
-            full_tran.NOTES = tran->NOTES;
-            full_tran.TAGNAMES = tranTagnames;
-            Model_Checking::Data splitWithTxnNotes = full_tran;
-            Model_Checking::Data splitWithSplitNotes = full_tran;
+            row.m_split_pos = pos;
+            row.m_split_num = splitIndex++;
+            Model_Checking::Data splitWithTxnNotes = *tran;
+            splitWithTxnNotes.CATEGID = split.CATEGID;
+            splitWithTxnNotes.TRANSAMOUNT = split.SPLITTRANSAMOUNT;
+            Model_Checking::Data splitWithSplitNotes = splitWithTxnNotes;
             splitWithSplitNotes.NOTES = split.NOTES;
             if (
                 !m_trans_filter_dlg->mmIsRecordMatches<Model_Checking>(splitWithSplitNotes, true) && 
@@ -811,22 +765,183 @@ void mmCheckingPanel::filterList()
             )
                 continue;
             if (isAccount()) {
-                full_tran.ACCOUNT_FLOW = Model_Checking::account_flow(splitWithTxnNotes, m_account_id);
-                m_flow += full_tran.ACCOUNT_FLOW;
+                row.ACCOUNT_FLOW = Model_Checking::account_flow(splitWithTxnNotes, m_account_id);
+                m_flow += row.ACCOUNT_FLOW;
             }
-            full_tran.NOTES.Append((tran->NOTES.IsEmpty() ? "" : " ") + split.NOTES);
-            wxString tagnames;
-            const wxString reftype = (repeat_num == 0) ? tranSplitRefType : billSplitRefType;
-            for (const auto& tag : Model_Taglink::instance().get(reftype, split.SPLITTRANSID))
-                tagnames.Append(tag.first + " ");
-            if (!tagnames.IsEmpty())
-                full_tran.TAGNAMES.Append((full_tran.TAGNAMES.IsEmpty() ? "" : ", ") + tagnames.Trim());
-            m_lc->m_trans.push_back(full_tran);
+            m_lc->m_trans.push_back(row);
         }
         // }
     }
 }
 
+// Patch the rows of the transactions in `before` (their state before an edit
+// or a delete) from their current state in the database. Returns false if the
+// change may affect the set or order of rows, in which case the caller must
+// rebuild the list with filterList().
+bool mmCheckingPanel::patchList(const Model_Checking::Data_Set& before)
+{
+    if (m_filter_id == FILTER_ID_ADVANCED)
+        return false;
+
+    const wxString tranRefType = Model_Checking::refTypeName;
+    auto& rows = m_lc->m_trans;
+    auto find_row = [&rows](int64 id) {
+        return std::find_if(rows.begin(), rows.end(),
+            [id](const TransactionListCtrl::TransRow& row) {
+                return row.m_repeat_num == 0 && row.TRANSID == id;
+            }
+        );
+    };
+    // get() hands out a blank record for an id that is gone, e.g. after a permanent delete
+    auto current = [](int64 id) -> const Model_Checking::Data* {
+        const Model_Checking::Data* tran = Model_Checking::instance().get(id);
+        return tran && tran->TRANSID == id ? tran : nullptr;
+    };
+
+    // check every transaction first, so a fallback never starts from a half patched list
+    for (const auto& old_tran : before) {
+        if (find_row(old_tran.TRANSID) == rows.end())
+            return false;
+        const Model_Checking::Data* tran = current(old_tran.TRANSID);
+        bool visible = tran && isDeletedTrans() != tran->DELETEDTIME.IsEmpty();
+        if (visible && (
+            tran->TRANSDATE != old_tran.TRANSDATE ||
+            tran->ACCOUNTID != old_tran.ACCOUNTID ||
+            tran->TOACCOUNTID != old_tran.TOACCOUNTID
+        ))
+            return false;
+    }
+
+    for (const auto& old_tran : before) {
+        const int64 id = old_tran.TRANSID;
+        auto row_it = find_row(id);
+        if (row_it == rows.end())
+            continue;   // listed twice in before, already removed
+
+        const Model_Checking::Data* tran = current(id);
+        bool visible = tran && isDeletedTrans() != tran->DELETEDTIME.IsEmpty();
+
+        const long sn = row_it->SN;
+        if (isAccount()) {
+            double old_flow = row_it->ACCOUNT_FLOW;
+            double new_flow = visible ? Model_Checking::account_flow(tran, m_account_id) : 0.0;
+            double delta = new_flow - old_flow;
+            for (auto& row : rows) {
+                if (row.SN >= sn)
+                    row.ACCOUNT_BALANCE += delta;
+            }
+            row_it->ACCOUNT_FLOW = new_flow;
+            m_flow += delta;
+            m_balance += delta;
+
+            bool old_reconciled = Model_Checking::status_id(old_tran.STATUS) ==
+                Model_Checking::STATUS_ID_RECONCILED;
+            bool new_reconciled = visible && Model_Checking::status_id(tran->STATUS) ==
+                Model_Checking::STATUS_ID_RECONCILED;
+            if (old_reconciled)
+                m_reconciled_balance -= old_flow;
+            else
+                m_unreconciled_count--;
+            if (new_reconciled)
+                m_reconciled_balance += new_flow;
+            else if (visible)
+                m_unreconciled_count++;
+            m_show_reconciled = (m_unreconciled_count > 0);
+        }
+
+        if (visible) {
+            m_trans_splits[id] = Model_Splittransaction::instance().find(
+                Model_Splittransaction::TRANSID(id)
+            );
+            m_trans_tags[id] = Model_Taglink::instance().find(
+                Model_Taglink::REFTYPE(tranRefType),
+                Model_Taglink::REFID(id)
+            );
+            m_trans_attachments[id] = Model_Attachment::instance().FilterAttachments(
+                tranRefType, id
+            );
+            Model_CustomFieldData::Data_Set fields;
+            for (const auto& field : Model_CustomField::instance().find(
+                Model_CustomField::DB_Table_CUSTOMFIELD_V1::REFTYPE(tranRefType)
+            )) {
+                for (const auto& data : Model_CustomFieldData::instance().find(
+                    Model_CustomFieldData::FIELDID(field.FIELDID),
+                    Model_CustomFieldData::REFID(id)
+                ))
+                    fields.push_back(data);
+            }
+            m_trans_fields[id] = fields;
+        }
+        else {
+            rows.erase(row_it);
+            for (auto& row : rows) {
+                if (row.SN > sn)
+                    row.SN--;
+            }
+            m_trans_splits.erase(id);
+            m_trans_tags.erase(id);
+            m_trans_attachments.erase(id);
+            m_trans_fields.erase(id);
+        }
+    }
+
+    m_lc->clearFullData();
+    countRefresh(REFRESH_ID_PATCH);
+    return true;
+}
+
+// Drop the rows outside of the current date range, after the range has been
+// narrowed from [old_start_str, old_end_str]. Returns false if the current
+// range is not contained in the old one.
+bool mmCheckingPanel::narrowList(const wxString& old_start_str, const wxString& old_end_str)
+{
+    const wxString date_start_str = m_date_range.checking_start_str();
+    const wxString date_end_str = m_date_range.checking_end_str();
+    if (date_start_str < old_start_str || date_end_str > old_end_str)
+        return false;
+
+    // compare dates as filterList() does: transaction dates in ISO combined
+    // format, scheduled dates as returned by Model_Billsdeposits::unroll()
+    auto& rows = m_lc->m_trans;
+    rows.erase(std::remove_if(rows.begin(), rows.end(),
+        [&](const TransactionListCtrl::TransRow& row) {
+            wxString tran_date = row.TRANSDATE;
+            if (row.m_repeat_num == 0 && tran_date.length() == 10)
+                tran_date += "T00:00:00";
+            return tran_date < date_start_str || tran_date > date_end_str;
+        }
+    ), rows.end());
+
+    // renumber the remaining rows in their original order
+    std::vector<long> sn_a;
+    sn_a.reserve(rows.size());
+    for (const auto& row : rows)
+        sn_a.push_back(row.SN);
+    std::sort(sn_a.begin(), sn_a.end());
+    sn_a.erase(std::unique(sn_a.begin(), sn_a.end()), sn_a.end());
+    m_flow = 0.0;
+    for (auto& row : rows) {
+        row.SN = static_cast<long>(
+            std::lower_bound(sn_a.begin(), sn_a.end(), row.SN) - sn_a.begin()
+        ) + 1;
+        m_flow += row.ACCOUNT_FLOW;
+    }
+
+    m_lc->clearFullData();
+    countRefresh(REFRESH_ID_NARROW);
+    return true;
+}
+
+void mmCheckingPanel::countRefresh(REFRESH_ID id)
+{
+    m_refresh_count[id]++;
+    wxLogDebug("mmCheckingPanel refresh: full %d, patch %d, narrow %d",
+        m_refresh_count[REFRESH_ID_FULL],
+        m_refresh_count[REFRESH_ID_PATCH],
+        m_refresh_count[REFRESH_ID_NARROW]
+    );
+}
+
 void mmCheckingPanel::sortList()
 {
     m_lc->sortList();
@@ -852,7 +967,7 @@ void mmCheckingPanel::updateExtraTransactionData(bool single, int repeat_num, bo
                 break;
         }
 
-        Fused_Transaction::Full_Data full_tran(m_lc->m_trans[x]);
+        Fused_Transaction::Full_Data full_tran(m_lc->getFullData(x));
         wxString miniStr = full_tran.info();
         //Show only first line but full string set as tooltip
         if (miniStr.Find("\n") > 1 && !miniStr.IsEmpty()) {
@@ -934,7 +1049,7 @@ void mmCheckingPanel::updateExtraTransactionData(bool single, int repeat_num, bo
                 if (item == -1) break;
                 if (currency)
                     flow += Model_Checking::account_flow(
-                        m_lc->m_trans[item],
+                        m_lc->getFullData(item),
                         m_account_id
                     );
                 wxString transdate = m_lc->m_trans[item].TRANSDATE;
@@ -1064,9 +1179,20 @@ void mmCheckingPanel::onFilterDate(wxCommandEvent& event)
     if (i < 0 || i >= static_cast<int>(m_date_range_a.size()))
         return;
 
+    // a narrower date range with the same other settings only drops rows
+    bool narrow = m_filter_id == FILTER_ID_DATE;
+    const wxString old_start_str = m_date_range.checking_start_str();
+    const wxString old_end_str = m_date_range.checking_end_str();
+    bool old_scheduled = m_scheduled_enable && m_scheduled_selected;
+
     setFilterDate(m_date_range_a[i]);
     updateFilterTooltip();
-    refreshList();
+
+    narrow = narrow && old_scheduled == (m_scheduled_enable && m_scheduled_selected);
+    if (narrow && narrowList(old_start_str, old_end_str))
+        m_lc->refreshVisualList(false);
+    else
+        refreshList();
 }
 
 void mmCheckingPanel::onFilterAdvanced(wxCommandEvent& WXUNUSED(event))
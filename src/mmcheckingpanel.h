@@ -28,6 +28,10 @@ Copyright (C) 2021 Mark Whalley (mark@ipx.co.uk)
 #include "fusedtransaction.h"
 #include "reports/mmDateRange.h"
 #include "model/Model_Account.h"
+#include "model/Model_Attachment.h"
+#include "model/Model_Budgetsplittransaction.h"
+#include "model/Model_CustomField.h"
+#include "model/Model_CustomFieldData.h"
 #include <map>
 //----------------------------------------------------------------------------
 class mmCheckingPanel;
@@ -82,6 +86,14 @@ private:
         FILTER_ID_size
     };
 
+    enum REFRESH_ID
+    {
+        REFRESH_ID_FULL = 0,
+        REFRESH_ID_PATCH,
+        REFRESH_ID_NARROW,
+        REFRESH_ID_size
+    };
+
     wxDECLARE_EVENT_TABLE();
     enum
     {
@@ -124,6 +136,22 @@ private:
     double m_balance = 0.0;
     double m_reconciled_balance = 0.0;
     bool m_show_reconciled;
+    int m_unreconciled_count = 0;
+
+    // number of list refreshes per path (full rebuild, row patch, range narrowing)
+    int m_refresh_count[REFRESH_ID_size] = {};
+
+    // loaded by filterList(); used by TransactionListCtrl::buildFullData()
+    std::map<int64, Model_Splittransaction::Data_Set> m_trans_splits;
+    std::map<int64, Model_Taglink::Data_Set> m_trans_tags;
+    std::map<int64, Model_Attachment::Data_Set> m_trans_attachments;
+    std::map<int64, Model_CustomFieldData::Data_Set> m_trans_fields;
+    std::map<int64, Model_Budgetsplittransaction::Data_Set> m_bills_splits;
+    std::map<int64, Model_Taglink::Data_Set> m_bills_tags;
+    std::map<int64, Model_Attachment::Data_Set> m_bills_attachments;
+    int64 m_udfc_id[5];
+    Model_CustomField::TYPE_ID m_udfc_type[5];
+    int m_udfc_scale[5];
 
     // set by showTips()
     bool m_show_tips = false;
@@ -167,6 +195,9 @@ private:
     void loadFilterSettings();
     void saveFilterSettings();
     void filterList();
+    bool patchList(const Model_Checking::Data_Set& before);
+    bool narrowList(const wxString& old_start_str, const wxString& old_end_str);
+    void countRefresh(REFRESH_ID id);
     void sortList();
     void updateExtraTransactionData(bool single, int repeat_num, bool foreign);
     void enableButtons(bool edit, bool dup, bool del, bool enter, bool skip, bool attach);
@@ -473,6 +473,8 @@ int mmGUIApp::OnExit()
     Model_Usage::instance().save(usage);
 
     if (m_setting_db) {
+        Model_Setting::instance().destroyCache();
+        Model_Usage::instance().destroyCache();
         m_setting_db->Close();
         m_setting_db->ShutdownSQLite();
     }
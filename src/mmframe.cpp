@@ -370,6 +370,9 @@ mmGUIFrame::~mmGUIFrame()
         wxASSERT(false);
     }
 
+    // The backup on close runs in the background, let it complete
+    dbUpgrade::WaitForBackups();
+
     // Report database statistics
     for (const auto & model : this->m_all_models) {
         model->show_statistics();
@@ -416,10 +419,11 @@ void mmGUIFrame::ShutdownDatabase()
             Model_Infotable::instance().setBool("ISUSED", false);
     }
     m_db->SetCommitHook(nullptr);
-    m_db->Close();
-    m_db.reset();
+    // cached prepared statements must be finalized before the connection is closed
     for (auto& model : m_all_models)
         model->destroyCache();
+    m_db->Close();
+    m_db.reset();
 }
 
 void mmGUIFrame::resetNavTreeControl()
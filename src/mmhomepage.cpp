@@ -652,36 +652,15 @@ htmlWidgetAccounts::htmlWidgetAccounts()
 
 void htmlWidgetAccounts::get_account_stats()
 {
-
-    wxSharedPtr<mmDateRange> date_range;
-    if (Option::instance().getIgnoreFutureTransactions())
-        date_range = new mmCurrentMonthToDate;
-    else
-        date_range = new mmCurrentMonth;
-
-    Model_Checking::Data_Set all_trans;
+    wxString date_iso;
     if (Option::instance().getIgnoreFutureTransactions())
     {
-        all_trans = Model_Checking::instance().find(Model_Checking::TRANSDATE(
-            Option::instance().UseTransDateTime() ? wxDateTime::Now() : wxDateTime(23, 59, 59, 999), LESS_OR_EQUAL));
-    }
-    else
-    {
-        all_trans = Model_Checking::instance().all();
-    }
-
-    for (const auto& trx : all_trans)
-    {
-        accountStats_[trx.ACCOUNTID].first += Model_Checking::account_recflow(trx, trx.ACCOUNTID);
-        accountStats_[trx.ACCOUNTID].second += Model_Checking::account_flow(trx, trx.ACCOUNTID);
-
-        if (Model_Checking::type_id(trx) == Model_Checking::TYPE_ID_TRANSFER)
-        {
-            accountStats_[trx.TOACCOUNTID].first += Model_Checking::account_recflow(trx, trx.TOACCOUNTID);
-            accountStats_[trx.TOACCOUNTID].second += Model_Checking::account_flow(trx, trx.TOACCOUNTID);
-        }
+        date_iso = Model_Checking::TRANSDATE(
+            Option::instance().UseTransDateTime() ? wxDateTime::Now() : wxDateTime(23, 59, 59, 999), LESS_OR_EQUAL).v_;
     }
 
+    for (const auto& account : Model_Account::instance().all())
+        accountStats_[account.ACCOUNTID] = Model_Account::instance().balance_flow(account.ACCOUNTID, date_iso);
 }
 
 const wxString htmlWidgetAccounts::displayAccounts(double& tBalance, double& tReconciled, int type = Model_Account::TYPE_ID_CHECKING)
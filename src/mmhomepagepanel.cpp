@@ -29,6 +29,7 @@ Copyright (C) 2022 Mark Whalley (mark@ipx.co.uk)
 #include "billsdepositspanel.h"
 #include <algorithm>
 #include <cmath>
+#include <functional>
 
 #include "constants.h"
 #include "option.h"
@@ -36,6 +37,149 @@ Copyright (C) 2022 Mark Whalley (mark@ipx.co.uk)
 
 #include "model/allmodel.h"
 
+namespace
+{
+    // A group of home page widgets and the tables it reads
+    struct Widget_Group
+    {
+        wxString name;
+        std::vector<const ModelBase*> models;
+        std::function<void(std::map<wxString, wxString>&)> build;
+    };
+
+    // Frames of a group, kept between page builds while the day and the
+    // generations of the tables the group reads match key
+    struct Widget_Frames
+    {
+        std::vector<size_t> key;
+        std::map<wxString, wxString> frames;
+    };
+    std::map<wxString, Widget_Frames> widget_cache;
+
+    void build_balances(std::map<wxString, wxString>& frames)
+    {
+        double tBalance = 0.0, tReconciled = 0.0;
+        double cardBalance = 0.0, cardReconciled = 0.0;
+        double termBalance = 0.0, termReconciled = 0.0;
+        double cashBalance = 0.0, cashReconciled = 0.0;
+        double loanBalance = 0.0, loanReconciled = 0.0;
+        double shareBalance = 0.0, shareReconciled = 0.0;
+        double assetBalance = 0.0, assetReconciled = 0.0;
+
+        htmlWidgetAccounts account_stats;
+        frames["ACCOUNTS_INFO"] = account_stats.displayAccounts(tBalance, tReconciled, Model_Account::TYPE_ID_CHECKING);
+        frames["CARD_ACCOUNTS_INFO"] = account_stats.displayAccounts(cardBalance, cardReconciled, Model_Account::TYPE_ID_CREDIT_CARD);
+        tBalance += cardBalance;
+        tReconciled += cardReconciled;
+
+        // Accounts
+        frames["CASH_ACCOUNTS_INFO"] = account_stats.displayAccounts(cashBalance, cashReconciled, Model_Account::TYPE_ID_CASH);
+        tBalance += cashBalance;
+        tReconciled += cashReconciled;
+
+        frames["LOAN_ACCOUNTS_INFO"] = account_stats.displayAccounts(loanBalance, loanReconciled, Model_Account::TYPE_ID_LOAN);
+        tBalance += loanBalance;
+        tReconciled += loanReconciled;
+
+        frames["TERM_ACCOUNTS_INFO"] = account_stats.displayAccounts(termBalance, termReconciled, Model_Account::TYPE_ID_TERM);
+        tBalance += termBalance;
+        tReconciled += termReconciled;
+
+        account_stats.displayAccounts(assetBalance, assetReconciled, Model_Account::TYPE_ID_ASSET);
+        tBalance += assetBalance;
+        tReconciled += assetReconciled;
+
+        account_stats.displayAccounts(shareBalance, shareReconciled, Model_Account::TYPE_ID_SHARES);
+        tBalance += shareBalance;
+        tReconciled += shareReconciled;
+
+        //Stocks
+        htmlWidgetStocks stocks_widget;
+        frames["STOCKS_INFO"] = stocks_widget.getHTMLText();
+        const double tStocks = stocks_widget.get_total();
+        tBalance += tStocks;
+
+        htmlWidgetAssets assets;
+        frames["ASSETS_INFO"] = assets.getHTMLText();
+        const double tAssets = Model_Asset::instance().balance();
+        tBalance += tAssets;
+
+        htmlWidgetGrandTotals grand_totals;
+        frames["GRAND_TOTAL"] = grand_totals.getHTMLText(tBalance, tReconciled, tAssets, tStocks);
+    }
+
+    const std::vector<Widget_Group>& widget_groups()
+    {
+        static const std::vector<Widget_Group> groups = {
+            { "BALANCES", { &Model_Account::instance(), &Model_Checking::instance()
+                , &Model_Currency::instance(), &Model_CurrencyHistory::instance(), &Model_Stock::instance()
+                , &Model_StockHistory::instance(), &Model_Shareinfo::instance(), &Model_Translink::instance()
+                , &Model_Asset::instance() }
+                , build_balances },
+            { "INCOME_VS_EXPENSES", { &Model_Account::instance(), &Model_Checking::instance()
+                , &Model_Currency::instance(), &Model_CurrencyHistory::instance() }
+                , [](std::map<wxString, wxString>& frames) {
+                    htmlWidgetIncomeVsExpenses income_vs_expenses;
+                    frames["INCOME_VS_EXPENSES"] = income_vs_expenses.getHTMLText();
+                } },
+            { "BILLS_AND_DEPOSITS", { &Model_Billsdeposits::instance(), &Model_Account::instance()
+                , &Model_Payee::instance(), &Model_Currency::instance() }
+                , [](std::map<wxString, wxString>& frames) {
+                    htmlWidgetBillsAndDeposits bills_and_deposits(_t("Upcoming Transactions"));
+                    frames["BILLS_AND_DEPOSITS"] = bills_and_deposits.getHTMLText();
+                } },
+            { "TOP_CATEGORIES", { &Model_Checking::instance(), &Model_Splittransaction::instance()
+                , &Model_Category::instance(), &Model_Account::instance()
+                , &Model_Currency::instance(), &Model_CurrencyHistory::instance() }
+                , [](std::map<wxString, wxString>& frames) {
+                    htmlWidgetTop7Categories top_trx;
+                    frames["TOP_CATEGORIES"] = top_trx.getHTMLText();
+                } },
+            { "STATISTICS", { &Model_Checking::instance() }
+                , [](std::map<wxString, wxString>& frames) {
+                    htmlWidgetStatistics stat_widget;
+                    frames["STATISTICS"] = stat_widget.getHTMLText();
+                } },
+            // only the currencies of open accounts are listed
+            { "CURRENCY_RATES", { &Model_Currency::instance(), &Model_CurrencyHistory::instance()
+                , &Model_Account::instance() }
+                , [](std::map<wxString, wxString>& frames) {
+                    htmlWidgetCurrency currency_rates;
+                    frames["CURRENCY_RATES"] = currency_rates.getHtmlText();
+                } },
+        };
+        return groups;
+    }
+
+    const Widget_Group& widget_group(const wxString& name)
+    {
+        const auto& groups = widget_groups();
+        return *std::find_if(groups.begin(), groups.end()
+            , [&name](const Widget_Group& group) { return group.name == name; });
+    }
+
+    std::vector<size_t> widget_key(const Widget_Group& group)
+    {
+        // Options and the home page settings live in these two tables, key[1] is also
+        // used to tell a database reopen from ordinary changes
+        std::vector<size_t> key = { static_cast<size_t>(ModelBase::to_day(wxDateTime::Today()))
+            , Model_Infotable::instance().generation(), Model_Setting::instance().generation() };
+        for (const auto model : group.models)
+            key.push_back(model->generation());
+        return key;
+    }
+
+    void build_widget(const Widget_Group& group)
+    {
+        Widget_Frames& entry = widget_cache[group.name];
+        entry.key = widget_key(group);
+        entry.frames.clear();
+        group.build(entry.frames);
+    }
+}
+
+wxString mmHomePagePanel::s_template;
+
 wxBEGIN_EVENT_TABLE(mmHomePagePanel, wxPanel)
     EVT_WEBVIEW_NAVIGATING(wxID_ANY, mmHomePagePanel::OnLinkClicked)
 wxEND_EVENT_TABLE()
@@ -86,18 +230,46 @@ bool mmHomePagePanel::Create(wxWindow *parent
 
 void  mmHomePagePanel::createHtml()
 {
-    // Read template from file
-    m_templateText.clear();
-    const wxString template_path = mmex::getPathResource(mmex::HOME_PAGE_TEMPLATE);
-    wxFileInputStream input(template_path);
-    wxTextInputStream text(input, "\x09", wxConvUTF8);
-    while (input.IsOk() && !input.Eof())
+    // Read template from file once per session
+    if (s_template.empty())
     {
-        m_templateText += text.ReadLine() + "\n";
+        const wxString template_path = mmex::getPathResource(mmex::HOME_PAGE_TEMPLATE);
+        wxFileInputStream input(template_path);
+        wxTextInputStream text(input, "\x09", wxConvUTF8);
+        while (input.IsOk() && !input.Eof())
+        {
+            s_template += text.ReadLine() + "\n";
+        }
     }
 
     insertDataIntoTemplate();
     fillData();
+
+    if (!m_pending.empty() && !m_scheduled)
+    {
+        m_scheduled = true;
+        CallAfter(&mmHomePagePanel::buildPending);
+    }
+}
+
+void mmHomePagePanel::buildPending()
+{
+    m_scheduled = false;
+    if (m_pending.empty())
+        return;
+
+    build_widget(widget_group(m_pending.front()));
+    m_pending.erase(m_pending.begin());
+
+    if (m_pending.empty())
+    {
+        createHtml();
+    }
+    else
+    {
+        m_scheduled = true;
+        CallAfter(&mmHomePagePanel::buildPending);
+    }
 }
 
 void mmHomePagePanel::createControls()
@@ -145,57 +317,6 @@ void mmHomePagePanel::insertDataIntoTemplate()
     adjustedLocale.Replace("_", "-");
     m_frames["LOCALE"] = adjustedLocale;
 
-    double tBalance = 0.0, tReconciled = 0.0;
-    double cardBalance = 0.0, cardReconciled = 0.0;
-    double termBalance = 0.0, termReconciled = 0.0;
-    double cashBalance = 0.0, cashReconciled = 0.0;
-    double loanBalance = 0.0, loanReconciled = 0.0;
-    double shareBalance = 0.0, shareReconciled = 0.0;
-    double assetBalance = 0.0, assetReconciled = 0.0;
-
-    htmlWidgetAccounts account_stats;
-    m_frames["ACCOUNTS_INFO"] = account_stats.displayAccounts(tBalance, tReconciled, Model_Account::TYPE_ID_CHECKING);
-    m_frames["CARD_ACCOUNTS_INFO"] = account_stats.displayAccounts(cardBalance, cardReconciled, Model_Account::TYPE_ID_CREDIT_CARD);
-    tBalance += cardBalance;
-    tReconciled += cardReconciled;
-
-    // Accounts
-    m_frames["CASH_ACCOUNTS_INFO"] = account_stats.displayAccounts(cashBalance, cashReconciled, Model_Account::TYPE_ID_CASH);
-    tBalance += cashBalance;
-    tReconciled += cashReconciled;
-
-    m_frames["LOAN_ACCOUNTS_INFO"] = account_stats.displayAccounts(loanBalance, loanReconciled, Model_Account::TYPE_ID_LOAN);
-    tBalance += loanBalance;
-    tReconciled += loanReconciled;
-
-    m_frames["TERM_ACCOUNTS_INFO"] = account_stats.displayAccounts(termBalance, termReconciled, Model_Account::TYPE_ID_TERM);
-    tBalance += termBalance;
-    tReconciled += termReconciled;
-
-    account_stats.displayAccounts(assetBalance, assetReconciled, Model_Account::TYPE_ID_ASSET);
-    tBalance += assetBalance;
-    tReconciled += assetReconciled;
-
-    account_stats.displayAccounts(shareBalance, shareReconciled, Model_Account::TYPE_ID_SHARES);
-    tBalance += shareBalance;
-    tReconciled += shareReconciled;
-
-    //Stocks
-    htmlWidgetStocks stocks_widget;
-    m_frames["STOCKS_INFO"] = stocks_widget.getHTMLText();
-    tBalance += stocks_widget.get_total();
-
-    htmlWidgetAssets assets;
-    m_frames["ASSETS_INFO"] = assets.getHTMLText();
-    tBalance += Model_Asset::instance().balance();
-
-    htmlWidgetGrandTotals grand_totals;
-    m_frames["GRAND_TOTAL"] = grand_totals.getHTMLText(tBalance, tReconciled
-                                                , Model_Asset::instance().balance(), stocks_widget.get_total());
-
-    //
-    htmlWidgetIncomeVsExpenses income_vs_expenses;
-    m_frames["INCOME_VS_EXPENSES"] = income_vs_expenses.getHTMLText();
     m_frames["INCOME_VS_EXPENSES_FORECOLOR"] = mmThemeMetaString(meta::COLOR_REPORT_FORECOLOR);
     m_frames["INCOME_VS_EXPENSES_COLORS"] = wxString::Format("'%s', '%s'", mmThemeMetaString(meta::COLOR_REPORT_CREDIT)
                                                 , mmThemeMetaString(meta::COLOR_REPORT_DEBIT));
@@ -204,20 +325,25 @@ void mmHomePagePanel::insertDataIntoTemplate()
     m_frames["INCOME_VS_EXPENSES_CURR_GROUP_SEPARATOR"] = baseCurrency ? baseCurrency->GROUP_SEPARATOR : ",";
     m_frames["INCOME_VS_EXPENSES_CURR_DECIMAL_POINT"] = baseCurrency ? baseCurrency->DECIMAL_POINT : ".";
     m_frames["INCOME_VS_EXPENSES_CURR_SCALE"] = baseCurrency ? wxString::Format("%d", static_cast<int>(log10(baseCurrency->SCALE.GetValue()))) : "";
-
-
-    htmlWidgetBillsAndDeposits bills_and_deposits(_t("Upcoming Transactions"));
-    m_frames["BILLS_AND_DEPOSITS"] = bills_and_deposits.getHTMLText();
-
-    htmlWidgetTop7Categories top_trx;
-    m_frames["TOP_CATEGORIES"] = top_trx.getHTMLText();
-
-    htmlWidgetStatistics stat_widget;
-    m_frames["STATISTICS"] = stat_widget.getHTMLText();
     m_frames["TOGGLES"] = getToggles();
 
-    htmlWidgetCurrency currency_rates;
-    m_frames["CURRENCY_RATES"] = currency_rates.getHtmlText();
+    // A group whose tables changed keeps its last frames on the page and is rebuilt
+    // later by buildPending(). A group never built, or built for a database that
+    // has been closed since (a reset in the Infotable journal), is built now.
+    m_pending.clear();
+    for (const auto& group : widget_groups())
+    {
+        const auto it = widget_cache.find(group.name);
+        std::vector<DB_Change> changes;
+        if (it == widget_cache.end()
+            || !Model_Infotable::instance().changes_since(it->second.key[1], changes))
+            build_widget(group);
+        else if (it->second.key != widget_key(group))
+            m_pending.push_back(group.name);
+
+        for (const auto& frame : widget_cache[group.name].frames)
+            m_frames[frame.first] = frame.second;
+    }
 }
 
 const wxString mmHomePagePanel::getToggles()
@@ -228,14 +354,34 @@ const wxString mmHomePagePanel::getToggles()
 
 void mmHomePagePanel::fillData()
 {
-    for (const auto& entry : m_frames)
+    // Substitute every <TMPL_VAR name> in one pass over the template,
+    // names without a frame are left in place
+    static const wxString tag = "<TMPL_VAR ";
+    wxString page;
+    page.reserve(s_template.size() * 2);
+    size_t pos = 0;
+    for (size_t start = s_template.find(tag); start != wxString::npos; start = s_template.find(tag, pos))
     {
-        m_templateText.Replace(wxString::Format("<TMPL_VAR %s>", entry.first), entry.second);
+        const size_t end = s_template.find('>', start + tag.size());
+        if (end == wxString::npos)
+            break;
+        page.append(s_template, pos, start - pos);
+        const auto it = m_frames.find(s_template.substr(start + tag.size(), end - start - tag.size()));
+        if (it != m_frames.end())
+            page.append(it->second);
+        else
+            page.append(s_template, start, end + 1 - start);
+        pos = end + 1;
     }
+    page.append(s_template, pos, wxString::npos);
+
+    // Nothing changed since the last build of this panel, keep the loaded page and its scroll position
+    if (page == m_templateText && !m_templateText.empty())
+        return;
+    m_templateText = page;
 
     const auto name = getVFname4print("hp", m_templateText);
     browser_->LoadURL(name);
-
 }
 
 void mmHomePagePanel::OnNewWindow(wxWebViewEvent& evt)
@@ -64,6 +64,11 @@ private:
     std::map <wxString, wxString> m_frames;
     void insertDataIntoTemplate();
     void fillData();
+    static wxString s_template;
+    std::vector<wxString> m_pending;   // stale widget groups, shown with their last frames
+    bool m_scheduled = false;
+    /** Rebuild the next stale widget group, then the page once all are done */
+    void buildPending();
     const wxString getToggles();
     void OnLinkClicked(wxWebViewEvent& event);
 
@@ -31,9 +31,12 @@
 #include "util.h"
 #include "reports/htmlbuilder.h"
 #include "model/allmodel.h"
+#include <wx/progdlg.h>
+#include <wx/stopwatch.h>
 #include <wx/wrapsizer.h>
 #include "option.h"
 #include <budgetentrydialog.h>
+#include <algorithm>
 #include <vector>
 #include <string>
 #include <iomanip>
@@ -98,6 +101,11 @@ bool mmReportsPanel::saveReportText(bool initial)
 {
 
     if (!rb_) return false;
+    if (m_running)
+    {
+        m_rerun = true;
+        return false;
+    }
 
     rb_->initial_report(initial);
     if (m_date_ranges)
@@ -144,7 +152,46 @@ bool mmReportsPanel::saveReportText(bool initial)
 
     const auto time = wxDateTime::UNow();
 
-    const auto& name = getVFname4print("rep", rb_->getHTMLText());
+    // A run longer than half a second shows a progress dialog, which is the only
+    // window taking input until the report is done or cancelled
+    m_running = true;
+    wxStopWatch timer;
+    long last_update = 0;
+    wxSharedPtr<wxProgressDialog> progressDlg;
+    rb_->setProgress([&](int done, int total)
+    {
+        if (m_rerun)
+            return false;
+        const long now = timer.Time();
+        if (now < 500 || now - last_update < 100)
+            return true;
+        last_update = now;
+        if (!progressDlg)
+        {
+            progressDlg = new wxProgressDialog(rb_->getReportTitle(), _tu("Please wait…"), 100, this
+                , wxPD_APP_MODAL | wxPD_CAN_ABORT | wxPD_AUTO_HIDE | wxPD_ELAPSED_TIME);
+        }
+        if (total > 0)
+            return progressDlg->Update(std::min(99, static_cast<int>(100LL * done / total)));
+        return progressDlg->Pulse();
+    });
+    const wxString html = rb_->getHTMLText();
+    const bool cancelled = rb_->cancelled();
+    rb_->setProgress(nullptr);
+    progressDlg.reset();
+    m_running = false;
+
+    // Settings changed during the run, run again with them
+    if (m_rerun)
+    {
+        m_rerun = false;
+        scheduleReport();
+    }
+    // A cancelled run keeps the page of the last complete one
+    if (cancelled)
+        return false;
+
+    const auto& name = getVFname4print("rep", html);
     browser_->LoadURL(name);
 
     json_writer.Key("seconds");
@@ -159,6 +206,23 @@ bool mmReportsPanel::saveReportText(bool initial)
     return true;
 }
 
+void mmReportsPanel::scheduleReport()
+{
+    if (m_running)
+        m_rerun = true;
+    if (m_running || m_scheduled)
+        return;
+
+    m_scheduled = true;
+    CallAfter(&mmReportsPanel::OnScheduledReport);
+}
+
+void mmReportsPanel::OnScheduledReport()
+{
+    m_scheduled = false;
+    saveReportText(false);
+}
+
 // Adjust wxStaticText size after font change
 // Workaround for not auto Layout() after SetFont()
 void mmSetOwnFont(wxStaticText* w, const wxFont& font)
@@ -427,14 +491,14 @@ void mmReportsPanel::OnYearChanged(wxCommandEvent& event)
 {
     const auto i = event.GetString();
     wxLogDebug("-------- %s", i);
-    saveReportText(false);
+    scheduleReport();
 }
 
 void mmReportsPanel::OnBudgetChanged(wxCommandEvent& event)
 {
     const auto i = event.GetString();
     wxLogDebug("-------- %s", i);
-    saveReportText(false);
+    scheduleReport();
     rb_->setReportSettings();
 }
 
@@ -452,7 +516,7 @@ void mmReportsPanel::OnDateRangeChanged(wxCommandEvent& WXUNUSED(event))
         rb_->setSelection(i);
         rb_->setReportSettings();
     }
-    saveReportText(false);
+    scheduleReport();
 }
 
 void mmReportsPanel::OnAccountChanged(wxCommandEvent& WXUNUSED(event))
@@ -469,7 +533,7 @@ void mmReportsPanel::OnAccountChanged(wxCommandEvent& WXUNUSED(event))
             }
             rb_->setAccounts(sel, accountSelection);
 
-            saveReportText(false);
+            scheduleReport();
             rb_->setReportSettings();
         }
     }
@@ -479,7 +543,7 @@ void mmReportsPanel::OnStartEndDateChanged(wxDateEvent& WXUNUSED(event))
 {
     if (rb_)
     {
-        saveReportText(false);
+        scheduleReport();
         rb_->setReportSettings();
     }
 }
@@ -492,7 +556,7 @@ void mmReportsPanel::OnChartChanged(wxCommandEvent& WXUNUSED(event))
         if ((sel == 1) || (sel != rb_->getChartSelection()))
         {
             rb_->chart(sel);
-            saveReportText(false);
+            scheduleReport();
             rb_->setReportSettings();
         }
     }
@@ -506,7 +570,7 @@ void mmReportsPanel::OnForwardMonthsChangedSpin(wxSpinEvent& WXUNUSED(event))
         if (sel != rb_->getForwardMonths())
         {
             rb_->setForwardMonths(sel);
-            saveReportText(false);
+            scheduleReport();
             rb_->setReportSettings();
         }
     }
@@ -526,7 +590,7 @@ void mmReportsPanel::OnShiftPressed(wxCommandEvent& event)
     {
         m_shift = event.GetInt();
         rb_->setSelection(m_shift);
-        saveReportText(false);
+        scheduleReport();
     }
 }
 
@@ -640,7 +704,6 @@ void mmReportsPanel::OnNewWindow(wxWebViewEvent& evt)
                         ShareTransactionDialog dlg(m_frame, &translink, transaction);
                         if (dlg.ShowModal() == wxID_OK)
                         {
-                            rb_->getHTMLText();
                             saveReportText();
                         }
                     }
@@ -649,7 +712,6 @@ void mmReportsPanel::OnNewWindow(wxWebViewEvent& evt)
                         mmAssetDialog dlg(m_frame, m_frame, &translink, transaction);
                         if (dlg.ShowModal() == wxID_OK)
                         {
-                            rb_->getHTMLText();
                             saveReportText();
                         }
                     }
@@ -659,12 +721,9 @@ void mmReportsPanel::OnNewWindow(wxWebViewEvent& evt)
                     mmTransDialog dlg(m_frame, -1, {transId, false});
                     if (dlg.ShowModal() != wxID_CANCEL)
                     {
-                        rb_->getHTMLText();
                         saveReportText();
                     }
                 }
-                const auto name = getVFname4print("rep", getPrintableBase()->getHTMLText());
-                browser_->LoadURL(name);
             }
         }
     }
@@ -735,7 +794,7 @@ void mmReportsPanel::OnNewWindow(wxWebViewEvent& evt)
         if (dlg.ShowModal() == wxID_OK)
         {
             //refresh report
-            saveReportText(false);
+            scheduleReport();
             rb_ ->setReportSettings();
             
         }
@@ -54,6 +54,8 @@ public:
     void sortList() {}
 
     bool saveReportText(bool initial = true);
+    /** Run the report once the pending events are handled, so a burst of changes runs it once */
+    void scheduleReport();
     mmPrintableBase* getPrintableBase();
     void PrintPage();
 
@@ -94,11 +96,15 @@ private:
     void OnForwardMonthsChangedSpin(wxSpinEvent& event);
     void OnForwardMonthsChangedText(wxCommandEvent& event);
     void OnShiftPressed(wxCommandEvent& event);
+    void OnScheduledReport();
 
     bool cleanup_;
     bool cleanupmem_ = false;
     int m_shift = 0;
     wxString htmlreport_;
+    bool m_running = false;     // getHTMLText() in progress
+    bool m_rerun = false;       // settings changed during the run, which is cancelled and repeated
+    bool m_scheduled = false;
 
 };
 
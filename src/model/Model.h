@@ -91,10 +91,65 @@ protected:
         return date;
     }
 
+public:
+    /** Days from 1970-01-01 to the given civil date */
+    static int to_day(int y, int m, int d)
+    {
+        y -= m <= 2;
+        const int era = (y >= 0 ? y : y - 399) / 400;
+        const int yoe = y - era * 400;
+        const int doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+        const int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + doe - 719468;
+    }
+    static int to_day(const wxDateTime& date)
+    {
+        return to_day(date.GetYear(), date.GetMonth() + 1, date.GetDay());
+    }
+    /** Civil date of a day number, inverse of to_day() */
+    static void from_day(int day, int& y, int& m, int& d)
+    {
+        day += 719468;
+        const int era = (day >= 0 ? day : day - 146096) / 146097;
+        const int doe = day - era * 146097;
+        const int yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        const int doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        const int mp = (5 * doy + 2) / 153;
+        d = doy - (153 * mp + 2) / 5 + 1;
+        m = mp < 10 ? mp + 3 : mp - 9;
+        y = yoe + era * 400 + (m <= 2);
+    }
+    /** ISO date string YYYY-MM-DD of a day number */
+    static const wxString day_iso(int day)
+    {
+        int y, m, d;
+        from_day(day, y, m, d);
+        return wxString::Format("%04d-%02d-%02d", y, m, d);
+    }
+    /** Day number of the leading YYYY-MM-DD of an ISO date string */
+    static bool to_day(const wxString& date_iso, int& day)
+    {
+        if (date_iso.length() < 10 || date_iso[4] != '-' || date_iso[7] != '-')
+            return false;
+
+        long y, m, d;
+        if (!date_iso.Mid(0, 4).ToLong(&y) || !date_iso.Mid(5, 2).ToLong(&m) || !date_iso.Mid(8, 2).ToLong(&d))
+            return false;
+        if (m < 1 || m > 12 || d < 1 || d > 31)
+            return false;
+
+        day = to_day(static_cast<int>(y), static_cast<int>(m), static_cast<int>(d));
+        return true;
+    }
+
 public:
     virtual wxString  GetTableStatsAsJson() const = 0;
     virtual void show_statistics() const = 0;
     virtual void destroyCache() = 0;
+    /** Change counter of the table, see DB_Table::generation() */
+    virtual size_t generation() const = 0;
+    /** Changes of the table after generation since, see DB_Table::changes_since() */
+    virtual bool changes_since(size_t since, std::vector<DB_Change>& changes) const = 0;
 
 protected:
     wxSQLite3Database* db_;
@@ -277,6 +332,12 @@ public:
         json_writer.Int(this->miss_);
         json_writer.Key("skip");
         json_writer.Int(this->skip_);
+        json_writer.Key("statements");
+        json_writer.Int(this->stmt_cache_.size());
+        json_writer.Key("stmt_hit");
+        json_writer.Int(this->stmt_hit_);
+        json_writer.Key("stmt_miss");
+        json_writer.Int(this->stmt_miss_);
         json_writer.EndObject();
 
         wxLogDebug("======== Model.h : GetTableStatsAsJson =======");
@@ -285,18 +346,34 @@ public:
         return wxString::FromUTF8(json_buffer.GetString());
     }
 
+    size_t generation() const
+    {
+        return DB_TABLE::generation();
+    }
+
+    bool changes_since(size_t since, std::vector<DB_Change>& changes) const
+    {
+        return DB_TABLE::changes_since(since, changes);
+    }
+
     void destroyCache()
     {
         if (this->cache_.size() > 0) this->destroy_cache();
+        else this->destroy_statements();
     }
 
     /** Show table statistics*/
     void show_statistics() const
     {
-        wxLogDebug("%s : (cache %zu, index_by_id %zu, hit %zu, miss %zu, skip %zu)",
+        wxLogDebug("%s : (cache %zu, index_by_id %zu, hit %zu, miss %zu, skip %zu, statements %zu, stmt_hit %zu, stmt_miss %zu)",
             this->name(),
             this->cache_.size(),
             this->index_by_id_.size(),
-            this->hit_, this->miss_, this->skip_);
+            this->hit_, this->miss_, this->skip_,
+            this->stmt_cache_.size(), this->stmt_hit_, this->stmt_miss_);
+#ifndef NDEBUG
+        for (const auto& [where, plan] : this->query_plans_)
+            wxLogDebug("%s %s: %zu x%s(%s)", this->name(), plan.scan ? "SCAN" : "INDEX", plan.count, where, plan.detail);
+#endif
     }
 };
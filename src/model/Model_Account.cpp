@@ -22,6 +22,7 @@
 #include "Model_Stock.h"
 #include "Model_Translink.h"
 #include "Model_Shareinfo.h"
+#include <algorithm>
 #include <unordered_set>
 
 ChoicesName Model_Account::TYPE_CHOICES = ChoicesName({
@@ -72,6 +73,7 @@ Model_Account& Model_Account::instance(wxSQLite3Database* db)
     ins.destroy_cache();
     ins.ensure(db);
     ins.preload();
+    ins.balance_reset();
 
     return ins;
 }
@@ -220,18 +222,91 @@ const Model_Billsdeposits::Data_Set Model_Account::billsdeposits(const Data& r)
 
 double Model_Account::balance(const Data* r)
 {
-    double sum = r->INITIALBAL;
-    for (const auto& tran: transactionsByDateTimeId(r))
+    return r->INITIALBAL + instance().balance_flow(r->ACCOUNTID).second;
+}
+
+double Model_Account::balance(const Data& r)
+{
+    return balance(&r);
+}
+
+std::pair<double, double> Model_Account::balance_flow(int64 account_id, const wxString& date_iso)
+{
+    if (!balance_loaded_)
+        balance_load();
+
+    auto it = balance_index_.find(account_id);
+    if (it == balance_index_.end())
+        return { 0.0, 0.0 };
+
+    BalanceEntry& entry = it->second;
+    if (date_iso.empty())
+        return { entry.total.rec, entry.total.all };
+
+    if (!entry.running_valid)
     {
-        sum += Model_Checking::account_flow(tran, r->ACCOUNTID); 
+        BalanceFlow sum;
+        entry.running.clear();
+        entry.running.reserve(entry.by_date.size());
+        for (const auto& day : entry.by_date)
+        {
+            sum.rec += day.second.rec;
+            sum.all += day.second.all;
+            entry.running.emplace_back(day.first, sum);
+        }
+        entry.running_valid = true;
     }
 
-    return sum;
+    auto pos = std::upper_bound(entry.running.begin(), entry.running.end(), date_iso
+        , [](const wxString& date, const std::pair<wxString, BalanceFlow>& item) { return date < item.first; });
+    if (pos == entry.running.begin())
+        return { 0.0, 0.0 };
+    --pos;
+    return { pos->second.rec, pos->second.all };
 }
 
-double Model_Account::balance(const Data& r)
+void Model_Account::balance_update(const Model_Checking::Data* r, int sign)
 {
-    return balance(&r);
+    // not built yet, the full scan on next use will pick up the change
+    if (!balance_loaded_)
+        return;
+
+    balance_add(r->ACCOUNTID, r->TRANSDATE
+        , sign * Model_Checking::account_flow(r, r->ACCOUNTID)
+        , sign * Model_Checking::account_recflow(r, r->ACCOUNTID));
+
+    if (Model_Checking::is_transfer(r) && r->TOACCOUNTID != r->ACCOUNTID)
+    {
+        balance_add(r->TOACCOUNTID, r->TRANSDATE
+            , sign * Model_Checking::account_flow(r, r->TOACCOUNTID)
+            , sign * Model_Checking::account_recflow(r, r->TOACCOUNTID));
+    }
+}
+
+void Model_Account::balance_reset()
+{
+    balance_index_.clear();
+    balance_loaded_ = false;
+}
+
+void Model_Account::balance_load()
+{
+    balance_index_.clear();
+    balance_loaded_ = true;
+    for (const auto& tran : Model_Checking::instance().all())
+        balance_update(&tran, 1);
+}
+
+void Model_Account::balance_add(int64 account_id, const wxString& date, double flow, double recflow)
+{
+    BalanceEntry& entry = balance_index_[account_id];
+    entry.total.all += flow;
+    entry.total.rec += recflow;
+
+    BalanceFlow& day = entry.by_date[date];
+    day.all += flow;
+    day.rec += recflow;
+    entry.running_valid = false;
 }
 
 std::pair<double, double> Model_Account::investment_balance(const Data* r)
@@ -113,6 +113,19 @@ public:
     static double balance(const Data* r);
     static double balance(const Data& r);
 
+    /**
+    * Return the flow of reconciled (first) and all (second) transactions of the account,
+    * limited to transactions with TRANSDATE up to date_iso when it is given.
+    * Served from the balance index, the initial balance is not included.
+    */
+    std::pair<double, double> balance_flow(int64 account_id, const wxString& date_iso = wxEmptyString);
+
+    /** Add (sign = 1) or take back (sign = -1) a transaction in the balance index */
+    void balance_update(const Model_Checking::Data* r, int sign);
+
+    /** Drop the balance index, it is rebuilt from CHECKINGACCOUNT_V1 on next use */
+    void balance_reset();
+
     static std::pair<double, double> investment_balance(const Data* r);
     static std::pair<double, double> investment_balance(const Data& r);
     static wxString toCurrency(double value, const Data* r);
@@ -150,6 +163,25 @@ public:
 
 public:
     static const wxString refTypeName;
+
+private:
+    struct BalanceFlow
+    {
+        double rec = 0.0;
+        double all = 0.0;
+    };
+    struct BalanceEntry
+    {
+        BalanceFlow total;
+        std::map<wxString, BalanceFlow> by_date;                // TRANSDATE -> flow of that date
+        std::vector<std::pair<wxString, BalanceFlow>> running;  // running sum over by_date
+        bool running_valid = false;
+    };
+    std::map<int64, BalanceEntry> balance_index_;
+    bool balance_loaded_ = false;
+
+    void balance_load();
+    void balance_add(int64 account_id, const wxString& date, double flow, double recflow);
 };
 
 //----------------------------------------------------------------------------
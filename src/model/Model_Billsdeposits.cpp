@@ -25,6 +25,7 @@
 #include "Model_Payee.h"
 #include "Model_Tag.h"
 #include "Model_CustomFieldData.h"
+#include <climits>
 
  /* TODO: Move attachment management outside of attachmentdialog */
 #include "attachmentdialog.h"
@@ -272,94 +273,189 @@ void Model_Billsdeposits::completeBDInSeries(int64 bdID)
 
 const wxDateTime Model_Billsdeposits::nextOccurDate(int repeatsType, int numRepeats, wxDateTime nextOccurDate, bool reverse)
 {
-    int k = reverse ? -1 : 1;
+    if (!nextOccurDate.IsValid())
+        return nextOccurDate;
 
+    const int day = to_day(nextOccurDate);
     wxDateTime dt = nextOccurDate;
-    if (repeatsType == REPEAT_WEEKLY)
-        dt.Add(wxTimeSpan::Weeks(k));
-    else if (repeatsType == REPEAT_BI_WEEKLY)
-        dt.Add(wxTimeSpan::Weeks(2 * k));
-    else if (repeatsType == REPEAT_MONTHLY)
-        dt.Add(wxDateSpan::Months(k));
-    else if (repeatsType == REPEAT_BI_MONTHLY)
-        dt.Add(wxDateSpan::Months(2 * k));
-    else if (repeatsType == REPEAT_FOUR_MONTHLY)
-        dt.Add(wxDateSpan::Months(4 * k));
-    else if (repeatsType == REPEAT_HALF_YEARLY)
-        dt.Add(wxDateSpan::Months(6 * k));
-    else if (repeatsType == REPEAT_YEARLY)
-        dt.Add(wxDateSpan::Years(k));
-    else if (repeatsType == REPEAT_QUARTERLY)
-        dt.Add(wxDateSpan::Months(3 * k));
-    else if (repeatsType == REPEAT_FOUR_WEEKLY)
-        dt.Add(wxDateSpan::Weeks(4 * k));
-    else if (repeatsType == REPEAT_DAILY)
-        dt.Add(wxDateSpan::Days(k));
-    else if (repeatsType == REPEAT_IN_X_DAYS) // repeat in numRepeats Days (Once only)
-        dt.Add(wxDateSpan::Days(numRepeats * k));
-    else if (repeatsType == REPEAT_IN_X_MONTHS) // repeat in numRepeats Months (Once only)
-        dt.Add(wxDateSpan::Months(numRepeats * k));
-    else if (repeatsType == REPEAT_EVERY_X_DAYS) // repeat every numRepeats Days
-        dt.Add(wxDateSpan::Days(numRepeats * k));
-    else if (repeatsType == REPEAT_EVERY_X_MONTHS) // repeat every numRepeats Months
-        dt.Add(wxDateSpan::Months(numRepeats * k));
-    else if (repeatsType == REPEAT_MONTHLY_LAST_DAY
-        ||   repeatsType == REPEAT_MONTHLY_LAST_BUSINESS_DAY)
-    {
-        dt.Add(wxDateSpan::Months(k));
+    dt.Add(wxDateSpan::Days(nextOccurDay(repeatsType, numRepeats, day, reverse) - day));
+    return dt;
+}
 
-        dt.SetToLastMonthDay(dt.GetMonth(), dt.GetYear());
-        if (repeatsType == REPEAT_MONTHLY_LAST_BUSINESS_DAY) // last weekday of month
-        {
-            if (dt.GetWeekDay() == wxDateTime::Sun || dt.GetWeekDay() == wxDateTime::Sat)
-                dt.SetToPrevWeekDay(wxDateTime::Fri);
-        }
+static int days_in_month(int y, int m)
+{
+    static const int days[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    return (m == 2 && y % 4 == 0 && (y % 100 != 0 || y % 400 == 0)) ? 29 : days[m - 1];
+}
+
+/** Add months to a day, keeping the day of month within the month like wxDateSpan does */
+static int add_months(int day, int months, bool last_day = false)
+{
+    int y, m, d;
+    ModelBase::from_day(day, y, m, d);
+    const int i = y * 12 + m - 1 + months;
+    y = (i >= 0 ? i : i - 11) / 12;
+    m = i - y * 12 + 1;
+    const int last = days_in_month(y, m);
+    return ModelBase::to_day(y, m, (last_day || d > last) ? last : d);
+}
+
+int Model_Billsdeposits::nextOccurDay(int repeatsType, int numRepeats, int day, bool reverse)
+{
+    const int k = reverse ? -1 : 1;
+    switch (repeatsType)
+    {
+    case REPEAT_WEEKLY:
+        return day + 7 * k;
+    case REPEAT_BI_WEEKLY:
+        return day + 14 * k;
+    case REPEAT_FOUR_WEEKLY:
+        return day + 28 * k;
+    case REPEAT_DAILY:
+        return day + k;
+    case REPEAT_IN_X_DAYS:      // repeat in numRepeats Days (Once only)
+    case REPEAT_EVERY_X_DAYS:   // repeat every numRepeats Days
+        return day + numRepeats * k;
+    case REPEAT_MONTHLY:
+        return add_months(day, k);
+    case REPEAT_BI_MONTHLY:
+        return add_months(day, 2 * k);
+    case REPEAT_QUARTERLY:
+        return add_months(day, 3 * k);
+    case REPEAT_FOUR_MONTHLY:
+        return add_months(day, 4 * k);
+    case REPEAT_HALF_YEARLY:
+        return add_months(day, 6 * k);
+    case REPEAT_YEARLY:
+        return add_months(day, 12 * k);
+    case REPEAT_IN_X_MONTHS:    // repeat in numRepeats Months (Once only)
+    case REPEAT_EVERY_X_MONTHS: // repeat every numRepeats Months
+        return add_months(day, numRepeats * k);
+    case REPEAT_MONTHLY_LAST_DAY:
+        return add_months(day, k, true);
+    case REPEAT_MONTHLY_LAST_BUSINESS_DAY: // last weekday of month
+    {
+        const int last = add_months(day, k, true);
+        const int weekday = ((last + 4) % 7 + 7) % 7; // 0 = Sunday, 1970-01-01 was a Thursday
+        return weekday == 0 ? last - 2 : (weekday == 6 ? last - 1 : last);
+    }
+    default:
+        return day;
     }
-    wxLogDebug("init date: %s -> next date: %s", nextOccurDate.FormatISOCombined(), dt.FormatISOCombined());
-    return dt;
 }
 
 wxArrayString Model_Billsdeposits::unroll(const Data* r, const wxString end_date, int limit)
 {
     wxArrayString dates;
-    int repeats = r->REPEATS.GetValue() % BD_REPEATS_MULTIPLEX_BASE;
-    int numRepeats = r->NUMOCCURRENCES.GetValue();
+    int first_day, end_day;
+    if (!to_day(r->TRANSDATE, first_day) || !to_day(end_date, end_day))
+        return dates;
+
+    // later occurrences keep the time of TRANSDATE in ISO combined format
+    const wxString time = (r->TRANSDATE.length() > 10 && r->TRANSDATE[10] == 'T')
+        ? r->TRANSDATE.Mid(10, 9) : wxString("T00:00:00");
+    const auto range = instance().timeline(r, first_day).range(first_day, end_day, limit);
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        const wxString date = (it == range.first) ? r->TRANSDATE : day_iso(*it) + time;
+        if (date > end_date)
+            break;
+        dates.push_back(date);
+    }
+
+    return dates;
+}
+
+wxArrayString Model_Billsdeposits::unroll(const Data& r, const wxString end_date, int limit)
+{
+    return unroll(&r, end_date, limit);
+}
 
+Model_Billsdeposits::Timeline::Timeline(int repeats, int numRepeats, int first_day)
+    : repeats_(repeats), numRepeats_(numRepeats), next_(first_day), finished_(false)
+{
     // ignore old inactive entries
-    if (repeats >= Model_Billsdeposits::REPEAT_IN_X_DAYS && repeats <= Model_Billsdeposits::REPEAT_EVERY_X_MONTHS && numRepeats == -1)
-        return dates;
+    if (repeats >= REPEAT_IN_X_DAYS && repeats <= REPEAT_EVERY_X_MONTHS && numRepeats == -1)
+        finished_ = true;
 
     // ignore invalid entries
-    if (repeats != Model_Billsdeposits::REPEAT_ONCE && (numRepeats == 0 || numRepeats < -1))
-        return dates;
+    if (repeats != REPEAT_ONCE && (numRepeats == 0 || numRepeats < -1))
+        finished_ = true;
+}
 
-    wxString date = r->TRANSDATE;
-    while (date <= end_date && limit != 0) {
-        if (limit > 0) limit--;
-        dates.push_back(date);
+std::pair<Model_Billsdeposits::Timeline::const_iterator, Model_Billsdeposits::Timeline::const_iterator>
+Model_Billsdeposits::Timeline::range(int from, int to, int limit)
+{
+    const size_t all = static_cast<size_t>(-1);
+    extend(from, all);
+    const size_t first = std::lower_bound(days_.begin(), days_.end(), from) - days_.begin();
+    extend(to, limit < 0 ? all : first + limit);
+
+    const auto begin = days_.begin() + first;
+    auto end = std::upper_bound(begin, days_.end(), to);
+    if (limit >= 0 && end - begin > limit)
+        end = begin + limit;
+    return std::make_pair(begin, end);
+}
 
-        if (repeats == Model_Billsdeposits::REPEAT_ONCE)
-            break;
-        if ((repeats < Model_Billsdeposits::REPEAT_IN_X_DAYS || repeats > Model_Billsdeposits::REPEAT_EVERY_X_MONTHS) && numRepeats == 1)
+/** Unroll the occurrences up to day to, or until the timeline holds count of them */
+void Model_Billsdeposits::Timeline::extend(int to, size_t count)
+{
+    while (!finished_ && next_ <= to && days_.size() < count)
+    {
+        days_.push_back(next_);
+
+        if (repeats_ == REPEAT_ONCE
+            || ((repeats_ < REPEAT_IN_X_DAYS || repeats_ > REPEAT_EVERY_X_MONTHS) && numRepeats_ == 1))
+        {
+            finished_ = true;
             break;
+        }
 
-        wxDateTime date_curr;
-        date_curr.ParseDateTime(date) || date_curr.ParseDate(date);
-        const wxDateTime& date_next = Model_Billsdeposits::nextOccurDate(repeats, numRepeats, date_curr);
-        date = date_next.FormatISOCombined();
+        const int next = nextOccurDay(repeats_, numRepeats_, next_);
+        if (next <= next_) // unknown repeat type
+        {
+            finished_ = true;
+            break;
+        }
+        next_ = next;
 
-        if ((repeats < Model_Billsdeposits::REPEAT_IN_X_DAYS || repeats > Model_Billsdeposits::REPEAT_EVERY_X_MONTHS) && numRepeats > 1)
-            numRepeats--;
-        else if (repeats >= Model_Billsdeposits::REPEAT_IN_X_DAYS && repeats <= Model_Billsdeposits::REPEAT_IN_X_MONTHS)
-            repeats = Model_Billsdeposits::REPEAT_ONCE;
+        if ((repeats_ < REPEAT_IN_X_DAYS || repeats_ > REPEAT_EVERY_X_MONTHS) && numRepeats_ > 1)
+            numRepeats_--;
+        else if (repeats_ >= REPEAT_IN_X_DAYS && repeats_ <= REPEAT_IN_X_MONTHS)
+            repeats_ = REPEAT_ONCE;
     }
+}
 
-    return dates;
+Model_Billsdeposits::Timeline& Model_Billsdeposits::timeline(const Data* r, int first_day)
+{
+    if (timelines_generation_ != generation())
+        timelines_update();
+
+    const int repeats = static_cast<int>(r->REPEATS.GetValue() % BD_REPEATS_MULTIPLEX_BASE);
+    const int numRepeats = static_cast<int>(r->NUMOCCURRENCES.GetValue());
+    // an edited copy of a schedule does not share the timeline of the saved one
+    const auto key = std::make_tuple(r->BDID, first_day, repeats, numRepeats);
+    auto it = timelines_.find(key);
+    if (it == timelines_.end())
+        it = timelines_.emplace(key, Timeline(repeats, numRepeats, first_day)).first;
+    return it->second;
 }
 
-wxArrayString Model_Billsdeposits::unroll(const Data& r, const wxString end_date, int limit)
+/** Drop the timelines of the schedules changed since timelines_generation_, or all of them */
+void Model_Billsdeposits::timelines_update()
 {
-    return unroll(&r, end_date, limit);
+    std::vector<DB_Change> changes;
+    if (!changes_since(timelines_generation_, changes))
+        timelines_.clear();
+
+    for (const auto& change : changes)
+    {
+        auto it = timelines_.lower_bound(std::make_tuple(change.id, INT_MIN, INT_MIN, INT_MIN));
+        while (it != timelines_.end() && std::get<0>(it->first) == change.id)
+            it = timelines_.erase(it);
+    }
+    timelines_generation_ = generation();
 }
 
 Model_Billsdeposits::Full_Data::Full_Data()
@@ -26,6 +26,8 @@
 #include "Model_Splittransaction.h"
 #include "Model_Budgetsplittransaction.h"
 #include "Model_Taglink.h"
+#include <map>
+#include <tuple>
 
 const int BD_REPEATS_MULTIPLEX_BASE = 100;
 
@@ -174,6 +176,45 @@ public:
 
     void completeBDInSeries(int64 bdID);
     static const wxDateTime nextOccurDate(int type, int numRepeats, wxDateTime nextOccurDate, bool reverse = false);
+    /** Same as nextOccurDate() on day numbers (ModelBase::to_day) */
+    static int nextOccurDay(int type, int numRepeats, int day, bool reverse = false);
+
+public:
+    /** Occurrence days of a schedule from its first day on, unrolled on demand */
+    class Timeline
+    {
+    public:
+        typedef std::vector<int>::const_iterator const_iterator;
+
+        /** Invalid or inactive schedules have no occurrences, as in unroll() */
+        Timeline(int repeats, int numRepeats, int first_day);
+        /**
+        * Return the first (at most limit) occurrences with from <= day <= to.
+        * The iterators are valid until the timeline is extended by the next call.
+        */
+        std::pair<const_iterator, const_iterator> range(int from, int to, int limit = -1);
+
+    private:
+        std::vector<int> days_;
+        int repeats_;
+        int numRepeats_;
+        int next_;
+        bool finished_;
+
+        void extend(int to, size_t count);
+    };
+
+    /**
+    * Return the timeline of the schedule starting at first_day (TRANSDATE or NEXTOCCURRENCEDATE),
+    * kept until the schedule changes.
+    */
+    Timeline& timeline(const Data* r, int first_day);
+
+private:
+    std::map<std::tuple<int64, int, int, int>, Timeline> timelines_; // (BDID, first day, repeats, numRepeats)
+    size_t timelines_generation_ = 0;
+
+    void timelines_update();
 
 public:
     static const wxString refTypeName;
@@ -25,6 +25,7 @@
 #include "reports/mmDateRange.h"
 #include "option.h"
 #include <tuple>
+#include <unordered_set>
 
 Model_Category::Model_Category(): Model<DB_Table_CATEGORY_V1>()
 {
@@ -108,27 +109,128 @@ const std::map<wxString, int64> Model_Category::all_categories(bool excludeHidde
     return full_categs;
 }
 
+static const wxString& categ_delimiter()
+{
+    static wxString delimiter;
+    if (delimiter.empty()) {
+        delimiter = Model_Infotable::instance().getString("CATEG_DELIMITER", ":");
+    }
+    return delimiter;
+}
+
+const Model_Category& Model_Category::tree()
+{
+    Model_Category& ins = instance();
+    if (ins.tree_generation_ != ins.generation())
+    {
+        ins.tree_load();
+        ins.tree_generation_ = ins.generation();
+    }
+    return ins;
+}
+
+/** Materialize the category tree: full names, depths, children and pre-order intervals */
+void Model_Category::tree_load()
+{
+    tree_.clear();
+    tree_index_.clear();
+
+    const Data_Set categories = all(COL_CATEGID);
+    std::unordered_set<int64> ids;
+    for (const auto& category : categories)
+        ids.insert(category.CATEGID);
+
+    std::unordered_map<int64, Data_Set> children;
+    Data_Set top;
+    for (const auto& category : categories)
+    {
+        // orphaned categories are placed at the top level
+        if (category.PARENTID == -1 || category.PARENTID == category.CATEGID || ids.find(category.PARENTID) == ids.end())
+            top.push_back(category);
+        else
+            children[category.PARENTID].push_back(category);
+    }
+
+    std::stable_sort(top.begin(), top.end(), SorterByCATEGNAME());
+    for (auto& item : children)
+        std::stable_sort(item.second.begin(), item.second.end(), SorterByCATEGNAME());
+
+    tree_.reserve(categories.size());
+    for (const auto& category : top)
+        tree_append(children, category, 0, "");
+
+    // categories caught in a PARENTID cycle cannot be reached from the top level
+    for (const auto& category : categories)
+        tree_append(children, category, 0, "");
+}
+
+void Model_Category::tree_append(std::unordered_map<int64, Data_Set>& children, const Data& category, int depth, const wxString& parent_name)
+{
+    if (tree_index_.find(category.CATEGID) != tree_index_.end())
+        return;
+
+    const size_t pos = tree_.size();
+    tree_index_[category.CATEGID] = pos;
+    const wxString name = depth == 0 ? category.CATEGNAME
+        : parent_name + categ_delimiter() + category.CATEGNAME;
+    tree_.push_back({ category.CATEGID, category.PARENTID, depth, pos, name, {} });
+
+    for (const auto& subcategory : children[category.CATEGID])
+    {
+        if (tree_index_.find(subcategory.CATEGID) != tree_index_.end())
+            continue;
+        tree_[pos].children.push_back(subcategory.CATEGID);
+        tree_append(children, subcategory, depth + 1, name);
+    }
+    tree_[pos].last = tree_.size() - 1;
+}
+
+const Model_Category::Node* Model_Category::node(int64 category_id)
+{
+    const Model_Category& t = tree();
+    const auto it = t.tree_index_.find(category_id);
+    return it != t.tree_index_.end() ? &t.tree_[it->second] : nullptr;
+}
+
+bool Model_Category::is_descendant(int64 category_id, int64 ancestor_id)
+{
+    const Model_Category& t = tree();
+    const auto c = t.tree_index_.find(category_id);
+    const auto a = t.tree_index_.find(ancestor_id);
+    if (c == t.tree_index_.end() || a == t.tree_index_.end())
+        return false;
+    return c->second > a->second && c->second <= t.tree_[a->second].last;
+}
+
 Model_Category::Data_Set Model_Category::sub_category(const Data* r)
 {
-    return instance().find(PARENTID(r->CATEGID));
+    Data_Set subcategories;
+    const Node* n = r ? node(r->CATEGID) : nullptr;
+    if (!n) return subcategories;
+
+    for (const auto& id : n->children) {
+        const Data* subcategory = instance().get(id);
+        if (subcategory) subcategories.push_back(*subcategory);
+    }
+    return subcategories;
 }
 
 Model_Category::Data_Set Model_Category::sub_category(const Data& r)
 {
-    return instance().find(PARENTID(r.CATEGID));
+    return sub_category(&r);
 }
 
 Model_Category::Data_Set Model_Category::sub_tree(const Data* r)
 {
     Data_Set subtree;
-    Data_Set subcategories = instance().find(PARENTID(r->CATEGID));
-    std::stable_sort(subcategories.begin(), subcategories.end(), SorterByCATEGNAME());
-    for (const auto& subcategory : subcategories) {
-        subtree.push_back(subcategory);
-        Data_Set subtreecats = sub_tree(subcategory);
-        for (const auto& cat : subtreecats) {
-            subtree.push_back(cat);
-        }
+    const Model_Category& t = tree();
+    const auto it = r ? t.tree_index_.find(r->CATEGID) : t.tree_index_.end();
+    if (it == t.tree_index_.end()) return subtree;
+
+    // the subtree is the pre-order interval following the node
+    for (size_t i = it->second + 1; i <= t.tree_[it->second].last; i++) {
+        const Data* subcategory = instance().get(t.tree_[i].CATEGID);
+        if (subcategory) subtree.push_back(*subcategory);
     }
     return subtree;
 }
@@ -140,28 +242,19 @@ Model_Category::Data_Set Model_Category::sub_tree(const Data& r)
 
 const wxString Model_Category::full_name(const Data* category)
 {
-    static wxString delimiter;
-    if (delimiter.empty()) {
-        delimiter = Model_Infotable::instance().getString("CATEG_DELIMITER", ":");
-    }
     if (!category) return "";
     if (category->PARENTID == -1)
         return category->CATEGNAME;
-    else {
-        wxString name = category->CATEGNAME;
-        Data* parentCategory = instance().get(category->PARENTID);
-        while (parentCategory) {
-            name = name.Prepend(delimiter).Prepend(parentCategory->CATEGNAME);
-            parentCategory = instance().get(parentCategory->PARENTID);
-        }
-        return name;
-    }
+
+    // the record may carry unsaved changes, so only the parent path comes from the tree
+    const Node* parent = node(category->PARENTID);
+    return parent ? parent->full_name + categ_delimiter() + category->CATEGNAME : category->CATEGNAME;
 }
 
 const wxString Model_Category::full_name(int64 category_id)
 {
-    Data* category = instance().get(category_id);
-    return full_name(category);
+    const Node* n = node(category_id);
+    return n ? n->full_name : "";
 }
 
 const wxString Model_Category::full_name(int64 category_id, wxString delimiter)
@@ -196,33 +289,89 @@ bool Model_Category::is_hidden(int64 catID)
 bool Model_Category::is_used(int64 id)
 {
     if (id < 0) return false;
-    const auto& trans = Model_Checking::instance().find(Model_Checking::CATEGID(id));
-    if (!trans.empty())
+    return usage().category_used(id);
+}
+
+bool Model_Category::Usage::payee_used(int64 payee_id) const
+{
+    return payee.find(payee_id) != payee.end();
+}
+
+bool Model_Category::Usage::category_used(int64 category_id) const
+{
+    return category.find(category_id) != category.end();
+}
+
+const wxString& Model_Category::Usage::category_name(int64 category_id) const
+{
+    static const wxString none;
+    const Node* n = node(category_id);
+    return n ? n->full_name : none;
+}
+
+const Model_Category::Usage& Model_Category::usage()
+{
+    Model_Category& ins = instance();
+    const std::array<size_t, 5> generation = {
+        ins.generation(),
+        Model_Checking::instance().generation(),
+        Model_Splittransaction::instance().generation(),
+        Model_Billsdeposits::instance().generation(),
+        Model_Budgetsplittransaction::instance().generation()
+    };
+    if (!ins.usage_loaded_ || generation != ins.usage_generation_)
     {
-        for (const auto& txn : trans)
-            if (txn.DELETEDTIME.IsEmpty())
-                return true;
+        ins.usage_load();
+        ins.usage_generation_ = generation;
     }
-    const auto& split = Model_Splittransaction::instance().find(Model_Checking::CATEGID(id));
-    if (!split.empty())
+    return ins.usage_;
+}
+
+/** Count the uses of every payee and category with one aggregate query */
+void Model_Category::usage_load()
+{
+    usage_ = Usage();
+    usage_loaded_ = true;
+
+    try
     {
-        for (const auto& txn : split)
-            if (Model_Checking::instance().get(txn.TRANSID)->DELETEDTIME.IsEmpty())
-                return true;
-    }
-    const auto& deposits = Model_Billsdeposits::instance().find(Model_Billsdeposits::CATEGID(id));
-    if (!deposits.empty()) return true;
-    const auto& deposit_split = Model_Budgetsplittransaction::instance().find(Model_Billsdeposits::CATEGID(id));
-    if (!deposit_split.empty()) return true;
-    Data_Set children = instance().find(PARENTID(id));
-    if (!children.empty()){
-        bool used = false;
-        for(const auto& child : children){
-            used = used || is_used(child.CATEGID);
+        wxSQLite3ResultSet q = db_->ExecuteQuery(
+            "SELECT 0, PAYEEID, COUNT(*) FROM CHECKINGACCOUNT_V1"
+            " WHERE DELETEDTIME IS NULL OR DELETEDTIME = '' GROUP BY PAYEEID"
+            " UNION ALL SELECT 0, PAYEEID, COUNT(*) FROM BILLSDEPOSITS_V1 GROUP BY PAYEEID"
+            " UNION ALL SELECT 1, CATEGID, COUNT(*) FROM CHECKINGACCOUNT_V1"
+            " WHERE DELETEDTIME IS NULL OR DELETEDTIME = '' GROUP BY CATEGID"
+            " UNION ALL SELECT 1, s.CATEGID, COUNT(*) FROM SPLITTRANSACTIONS_V1 s"
+            " JOIN CHECKINGACCOUNT_V1 t ON t.TRANSID = s.TRANSID"
+            " WHERE t.DELETEDTIME IS NULL OR t.DELETEDTIME = '' GROUP BY s.CATEGID"
+            " UNION ALL SELECT 1, CATEGID, COUNT(*) FROM BILLSDEPOSITS_V1 GROUP BY CATEGID"
+            " UNION ALL SELECT 1, CATEGID, COUNT(*) FROM BUDGETSPLITTRANSACTIONS_V1 GROUP BY CATEGID"
+        );
+        while (q.NextRow())
+        {
+            const int64 id = q.GetInt64(1);
+            const int count = q.GetInt(2);
+            if (id < 0 || count == 0) continue;
+            if (q.GetInt(0) == 0)
+            {
+                usage_.payee[id] += count;
+                continue;
+            }
+
+            // a category is in use when any of its subcategories is
+            const Node* n = node(id);
+            if (!n)
+                usage_.category[id] += count;
+            for (; n; n = n->depth > 0 ? node(n->PARENTID) : nullptr)
+                usage_.category[n->CATEGID] += count;
         }
-        return used;
+        q.Finalize();
+    }
+    catch (const wxSQLite3Exception &e)
+    {
+        wxLogError("CATEGORY_V1: Exception %s", e.GetMessage().utf8_str());
+        usage_loaded_ = false;
     }
-    return false;
 }
 bool Model_Category::has_income(int64 id)
 {
@@ -274,16 +423,16 @@ void Model_Category::getCategoryStats(
 {
     //Initialization
     //Set std::map with zerros
-    const auto& allcategories = instance().all();
+    const auto& allcategories = tree().tree_;
     double value = 0;
     int columns = group_by_month ? 12 : 1;
     const wxDateTime start_date(date_range->start_date());
 
-    std::vector<std::pair<wxDateTime, int>> monthMap;
+    std::vector<std::pair<int, int>> monthMap;
     for (int m = 0; m < columns; m++)
     {
         const wxDateTime d = start_date.Add(wxDateSpan::Months(m));
-        monthMap.emplace_back(d, m);
+        monthMap.emplace_back(to_day(d), m);
     }
     std::reverse(monthMap.begin(), monthMap.end());
 
@@ -295,49 +444,52 @@ void Model_Category::getCategoryStats(
             categoryStats[category.CATEGID][month] = value;
         }
     }
-    //Calculations
-    auto splits = Model_Splittransaction::instance().get_all();
-    for (const auto& transaction : Model_Checking::instance().find(
-        Model_Checking::STATUS(Model_Checking::STATUS_ID_VOID, NOT_EQUAL)
-        , Model_Checking::TRANSDATE(date_range->start_date(), GREATER_OR_EQUAL)
-        , Model_Checking::TRANSDATE(date_range->end_date().FormatISOCombined(), LESS_OR_EQUAL)))
+
+    // Currency of each selected account
+    std::map<int64, int64> accountCurrency;
+    for (const auto& account : Model_Account::instance().all())
     {
-        if (!transaction.DELETEDTIME.IsEmpty()) continue;
+        if (accountArray && wxNOT_FOUND == accountArray->Index(account.ACCOUNTNAME))
+            continue;
+        accountCurrency[account.ACCOUNTID] = account.CURRENCYID;
+    }
 
-        if (accountArray)
-        {
-            const auto account = Model_Account::instance().get(transaction.ACCOUNTID);
-            if (wxNOT_FOUND == accountArray->Index(account->ACCOUNTNAME)) {
-                continue;
-            }
-        }
+    //Calculations
+    const auto splits = Model_Splittransaction::instance().get_all();
+    const auto& tran = Model_Checking::instance().columns();
+    const auto rows = tran.range(to_day(date_range->start_date()), to_day(date_range->end_date()));
+    for (size_t i = rows.first; i < rows.second; i++)
+    {
+        if (tran.STATUS[i] == Model_Checking::STATUS_ID_VOID || tran.DELETED[i]) continue;
 
-        const double convRate = Model_CurrencyHistory::getDayRate(
-            Model_Account::instance().get(transaction.ACCOUNTID)->CURRENCYID, transaction.TRANSDATE);
-        wxDateTime d = Model_Checking::TRANSDATE(transaction);
+        const auto account = accountCurrency.find(tran.ACCOUNTID[i]);
+        if (account == accountCurrency.end())
+            continue;
+        const double convRate = Model_CurrencyHistory::getDayRate(account->second, tran.DAY[i]);
 
         int month = 0;
         if (group_by_month)
         {
+            const int d = tran.DAY[i];
             auto it = std::find_if(monthMap.begin(), monthMap.end()
-                , [d](std::pair<wxDateTime, int> date){return d >= date.first;});
+                , [d](const std::pair<int, int>& date){return d >= date.first;});
             month = it->second;
         }
 
-        int64 categID = transaction.CATEGID;
+        int64 categID = tran.CATEGID[i];
 
         if (categID > -1)
         {
-            if (Model_Checking::type_id(transaction) != Model_Checking::TYPE_ID_TRANSFER)
+            if (tran.TYPE[i] != Model_Checking::TYPE_ID_TRANSFER)
             {
                 // Do not include asset or stock transfers in income expense calculations.
-                if (Model_Checking::foreignTransactionAsTransfer(transaction))
+                if (tran.foreign_as_transfer(i))
                     continue;
-                categoryStats[categID][month] += Model_Checking::account_flow(transaction, transaction.ACCOUNTID) * convRate;
+                categoryStats[categID][month] += tran.account_flow(i, tran.ACCOUNTID[i]) * convRate;
             }
             else if (budgetAmt != 0)
             {
-                double amt = transaction.TRANSAMOUNT * convRate;
+                double amt = tran.TRANSAMOUNT[i] * convRate;
                 if ((*budgetAmt)[categID] < 0)
                     categoryStats[categID][month] -= amt;
                 else
@@ -346,11 +498,30 @@ void Model_Category::getCategoryStats(
         }
         else
         {
-            for (const auto& entry : splits[transaction.id()])
+            const auto split = splits.find(tran.TRANSID[i]);
+            if (split == splits.end())
+                continue;
+            for (const auto& entry : split->second)
             {
                 categoryStats[entry.CATEGID][month] += entry.SPLITTRANSAMOUNT
-                    * convRate * ((Model_Checking::type_id(transaction) == Model_Checking::TYPE_ID_WITHDRAWAL) ? -1 : 1);
+                    * convRate * ((tran.TYPE[i] == Model_Checking::TYPE_ID_WITHDRAWAL) ? -1 : 1);
             }
         }
     }
 }
+
+void Model_Category::rollupCategoryStats(std::map<int64, std::map<int, double>>& categoryStats)
+{
+    const Model_Category& t = tree();
+    // in reverse pre-order a subtree is complete before its root is added to the parent
+    for (auto it = t.tree_.rbegin(); it != t.tree_.rend(); ++it)
+    {
+        if (it->depth == 0) continue;
+        const auto stats = categoryStats.find(it->CATEGID);
+        if (stats == categoryStats.end()) continue;
+
+        auto& parent = categoryStats[it->PARENTID];
+        for (const auto& [month, value] : stats->second)
+            parent[month] += value;
+    }
+}
@@ -22,6 +22,9 @@
 
 #include "Model.h"
 #include <wx/sharedptr.h>
+#include <array>
+#include <unordered_map>
+#include <vector>
 #include "db/DB_Table_Category_V1.h"
 
 class mmDateRange;
@@ -80,8 +83,56 @@ public:
         , bool group_by_month = true
         , std::map<int64, double >*budgetAmt = nullptr
         , bool fin_months = false);
+    /** Add the stats of every category into all of its ancestors, in one bottom-up pass */
+    static void rollupCategoryStats(std::map<int64, std::map<int, double>>& categoryStats);
     static const wxString full_name(const Data* category);
 
+    /** A category in the materialized tree, stored in pre-order */
+    struct Node
+    {
+        int64 CATEGID;
+        int64 PARENTID;
+        int depth;                      // 0 for a top level category
+        size_t last;                    // pre-order position of the last node of the subtree
+        wxString full_name;
+        std::vector<int64> children;    // sorted by CATEGNAME
+    };
+
+    /** Return the tree node of the category, or nullptr */
+    static const Node* node(int64 category_id);
+    /** True when the category lies strictly below the ancestor */
+    static bool is_descendant(int64 category_id, int64 ancestor_id);
+
+    /**
+    * Use counts of payees and categories over active transactions, their splits,
+    * scheduled transactions and their splits, with the full category names.
+    */
+    struct Usage
+    {
+        std::unordered_map<int64, int> payee;
+        std::unordered_map<int64, int> category; // rolled up into the parent categories
+
+        bool payee_used(int64 payee_id) const;
+        bool category_used(int64 category_id) const;
+        const wxString& category_name(int64 category_id) const;
+    };
+
+    /** Return the usage snapshot, rebuilt only when one of its source tables has changed */
+    static const Usage& usage();
+
+private:
+    std::vector<Node> tree_;
+    std::unordered_map<int64, size_t> tree_index_;
+    size_t tree_generation_ = static_cast<size_t>(-1);
+    /** Return the tree, rebuilt only when CATEGORY_V1 has changed */
+    static const Model_Category& tree();
+    void tree_load();
+    void tree_append(std::unordered_map<int64, Data_Set>& children, const Data& category, int depth, const wxString& parent_name);
+
+    Usage usage_;
+    std::array<size_t, 5> usage_generation_ = {};
+    bool usage_loaded_ = false;
+    void usage_load();
 };
 
 #endif //
@@ -23,6 +23,7 @@
 #include "Model_Payee.h"
 #include "Model_Category.h"
 #include <queue>
+#include <algorithm>
 #include "Model_Tag.h"
 #include "Model_Translink.h"
 #include "Model_CustomFieldData.h"
@@ -83,6 +84,9 @@ Model_Checking& Model_Checking::instance(wxSQLite3Database* db)
     ins.db_ = db;
     ins.destroy_cache();
     ins.ensure(db);
+    ins.columns_reset();
+    ins.autocomplete_reset();
+    Model_Account::instance().balance_reset();
 
     return ins;
 }
@@ -107,15 +111,37 @@ bool Model_Checking::remove(int64 id)
     // remove all custom fields for the transaction
     Model_CustomFieldData::DeleteAllData(RefType, id);
     Model_Taglink::instance().DeleteAllTags(RefType, id);
-    return this->remove(id, db_);
+
+    // get_record() returns the table owned fake_ for a missing id, which must not be adopted
+    Data* record = instance().get_record(id);
+    wxSharedPtr<Data> oldData(record && record->id() == id ? record : nullptr);
+    if (!this->remove(id, db_))
+        return false;
+    if (oldData) {
+        Model_Account::instance().balance_update(oldData.get(), -1);
+        columns_update(oldData.get(), -1);
+        autocomplete_update(oldData.get(), -1);
+    }
+    return true;
 }
 
 int64 Model_Checking::save(Data* r)
 {
-    wxSharedPtr<Data> oldData(instance().get_record(r->TRANSID));
+    Data* record = instance().get_record(r->TRANSID);
+    wxSharedPtr<Data> oldData(record && record->id() == r->TRANSID ? record : nullptr);
     if (!oldData || (!oldData->equals(r) && oldData->DELETEDTIME.IsEmpty() && r->DELETEDTIME.IsEmpty()))
         r->LASTUPDATEDTIME = wxDateTime::Now().ToUTC().FormatISOCombined();
-    this->save(r, db_);
+    if (this->save(r, db_))
+    {
+        if (oldData) {
+            Model_Account::instance().balance_update(oldData.get(), -1);
+            columns_update(oldData.get(), -1);
+            autocomplete_update(oldData.get(), -1);
+        }
+        Model_Account::instance().balance_update(r, 1);
+        columns_update(r, 1);
+        autocomplete_update(r, 1);
+    }
     return r->TRANSID;
 }
 
@@ -450,51 +476,9 @@ wxString Model_Checking::Full_Data::info() const
     return info;
 }
 
-bool CompareUsedNotes(const std::tuple<int, wxString, wxString>& a, const std::tuple<int, wxString, wxString>& b)
-{
-    if (std::get<0>(a) < std::get<0>(b)) return true;
-    if (std::get<0>(b) < std::get<0>(a)) return false;
-
-    // a=b for primary condition, go to secondary (but reverse order)
-    if (std::get<1>(a) > std::get<1>(b)) return true;
-    if (std::get<1>(b) > std::get<1>(a)) return false;
-
-    return false;
-}
-
 void Model_Checking::getFrequentUsedNotes(std::vector<wxString> &frequentNotes, int64 accountID)
 {
-    frequentNotes.clear();
-    size_t max = 20;
-
-    const auto notes = instance().find(NOTES("", NOT_EQUAL)
-        , accountID > 0 ? ACCOUNTID(accountID) : ACCOUNTID(-1, NOT_EQUAL));
-
-    // Count frequency
-    std::map <wxString, std::pair<int, wxString> > counterMap;
-    for (const auto& entry : notes)
-    {
-        auto& counter = counterMap[entry.NOTES];
-        counter.first--;
-        if (entry.TRANSDATE > counter.second)
-            counter.second = entry.TRANSDATE;
-    }
-
-    // Convert to vector
-    std::vector<std::tuple<int, wxString, wxString> > vec;
-    for (const auto& [note, counter] : counterMap)
-        vec.emplace_back(counter.first, counter.second, note);
-
-    // Sort by frequency then date
-    std::sort(vec.begin(), vec.end(), CompareUsedNotes);
-
-    // Pull out top 20 (max)
-    for (const auto& kv : vec)
-    {
-        if (0 == max--)
-            break;
-        frequentNotes.push_back(std::get<2>(kv));
-    }
+    frequentNotes = instance().autocomplete(AUTOCOMPLETE_NOTES, accountID > 0 ? accountID : -1);
 }
 
 void Model_Checking::getEmptyData(Data &data, int64 accountID)
@@ -641,6 +625,336 @@ bool Model_Checking::foreignTransactionAsTransfer(const Data& data)
     return foreignTransaction(data) && (data.TOACCOUNTID == Model_Translink::AS_TRANSFER || data.TOACCOUNTID == data.ACCOUNTID);
 }
 
+std::pair<size_t, size_t> Model_Checking::Columns::range(int first_day, int last_day) const
+{
+    auto first = std::lower_bound(DAY.begin(), DAY.end(), first_day);
+    auto last = std::upper_bound(first, DAY.end(), last_day);
+    return { first - DAY.begin(), last - DAY.begin() };
+}
+
+bool Model_Checking::Columns::foreign_as_transfer(size_t i) const
+{
+    return TOACCOUNTID[i] > 0 && TYPE[i] != TYPE_ID_TRANSFER &&
+        (TOACCOUNTID[i] == Model_Translink::AS_TRANSFER || TOACCOUNTID[i] == ACCOUNTID[i]);
+}
+
+double Model_Checking::Columns::account_flow(size_t i, int64 account_id) const
+{
+    if (TYPE[i] == TYPE_ID_TRANSFER && ACCOUNTID[i] == TOACCOUNTID[i])
+        return 0.0;  // Self Transfer as Revaluation
+    if (STATUS[i] == STATUS_ID_VOID || DELETED[i])
+        return 0.0;
+    if (account_id == ACCOUNTID[i] && TYPE[i] == TYPE_ID_WITHDRAWAL)
+        return -TRANSAMOUNT[i];
+    if (account_id == ACCOUNTID[i] && TYPE[i] == TYPE_ID_DEPOSIT)
+        return TRANSAMOUNT[i];
+    if (account_id == ACCOUNTID[i] && TYPE[i] == TYPE_ID_TRANSFER)
+        return -TRANSAMOUNT[i];
+    if (account_id == TOACCOUNTID[i] && TYPE[i] == TYPE_ID_TRANSFER)
+        return TOTRANSAMOUNT[i];
+    return 0.0;
+}
+
+void Model_Checking::Columns::insert(size_t i, int day, const Data* r)
+{
+    TRANSID.insert(TRANSID.begin() + i, r->TRANSID);
+    ACCOUNTID.insert(ACCOUNTID.begin() + i, r->ACCOUNTID);
+    TOACCOUNTID.insert(TOACCOUNTID.begin() + i, r->TOACCOUNTID);
+    PAYEEID.insert(PAYEEID.begin() + i, r->PAYEEID);
+    CATEGID.insert(CATEGID.begin() + i, r->CATEGID);
+    DAY.insert(DAY.begin() + i, day);
+    TYPE.insert(TYPE.begin() + i, static_cast<unsigned char>(type_id(r)));
+    STATUS.insert(STATUS.begin() + i, static_cast<unsigned char>(status_id(r)));
+    DELETED.insert(DELETED.begin() + i, !r->DELETEDTIME.IsEmpty());
+    TRANSAMOUNT.insert(TRANSAMOUNT.begin() + i, r->TRANSAMOUNT);
+    TOTRANSAMOUNT.insert(TOTRANSAMOUNT.begin() + i, r->TOTRANSAMOUNT);
+}
+
+void Model_Checking::Columns::erase(size_t i)
+{
+    TRANSID.erase(TRANSID.begin() + i);
+    ACCOUNTID.erase(ACCOUNTID.begin() + i);
+    TOACCOUNTID.erase(TOACCOUNTID.begin() + i);
+    PAYEEID.erase(PAYEEID.begin() + i);
+    CATEGID.erase(CATEGID.begin() + i);
+    DAY.erase(DAY.begin() + i);
+    TYPE.erase(TYPE.begin() + i);
+    STATUS.erase(STATUS.begin() + i);
+    DELETED.erase(DELETED.begin() + i);
+    TRANSAMOUNT.erase(TRANSAMOUNT.begin() + i);
+    TOTRANSAMOUNT.erase(TOTRANSAMOUNT.begin() + i);
+}
+
+size_t Model_Checking::Columns::lower_bound(int day, int64 id) const
+{
+    const auto r = range(day, day);
+    auto it = std::lower_bound(TRANSID.begin() + r.first, TRANSID.begin() + r.second, id);
+    return it - TRANSID.begin();
+}
+
+int Model_Checking::columns_day(const wxString& date_iso)
+{
+    int day;
+    if (to_day(date_iso, day))
+        return day;
+    const wxDateTime date = to_date(date_iso);
+    return date.IsValid() ? to_day(date) : 0;
+}
+
+const Model_Checking::Columns& Model_Checking::columns()
+{
+    if (!columns_loaded_)
+        columns_load();
+    return columns_;
+}
+
+void Model_Checking::columns_reset()
+{
+    columns_ = Columns();
+    columns_loaded_ = false;
+}
+
+/** Load the snapshot with one query over the needed columns, bypassing the Data cache */
+void Model_Checking::columns_load()
+{
+    columns_ = Columns();
+    columns_loaded_ = true;
+    try
+    {
+        // the day of an ISO date orders like its leading YYYY-MM-DD
+        wxSQLite3ResultSet q = db_->ExecuteQuery(
+            "SELECT TRANSID, ACCOUNTID, TOACCOUNTID, PAYEEID, CATEGID, TRANSDATE, TRANSCODE, STATUS"
+            ", DELETEDTIME, TRANSAMOUNT, TOTRANSAMOUNT"
+            " FROM CHECKINGACCOUNT_V1 ORDER BY SUBSTR(TRANSDATE, 1, 10), TRANSID"
+        );
+        while (q.NextRow())
+        {
+            columns_.TRANSID.push_back(q.GetInt64(0));
+            columns_.ACCOUNTID.push_back(q.GetInt64(1));
+            columns_.TOACCOUNTID.push_back(q.GetInt64(2));
+            columns_.PAYEEID.push_back(q.GetInt64(3));
+            columns_.CATEGID.push_back(q.GetInt64(4));
+            columns_.DAY.push_back(columns_day(q.GetString(5)));
+            columns_.TYPE.push_back(static_cast<unsigned char>(type_id(q.GetString(6))));
+            columns_.STATUS.push_back(static_cast<unsigned char>(status_id(q.GetString(7))));
+            columns_.DELETED.push_back(!q.GetString(8).IsEmpty());
+            columns_.TRANSAMOUNT.push_back(q.GetDouble(9));
+            columns_.TOTRANSAMOUNT.push_back(q.GetDouble(10));
+        }
+        q.Finalize();
+    }
+    catch (const wxSQLite3Exception &e)
+    {
+        wxLogError("CHECKINGACCOUNT_V1: Exception %s", e.GetMessage().utf8_str());
+        columns_reset();
+    }
+}
+
+/** Apply a saved (sign = 1) or removed (sign = -1) record to a loaded snapshot */
+void Model_Checking::columns_update(const Data* r, int sign)
+{
+    if (!columns_loaded_)
+        return;
+
+    const int day = columns_day(r->TRANSDATE);
+    const size_t i = columns_.lower_bound(day, r->TRANSID);
+    if (sign > 0)
+        columns_.insert(i, day, r);
+    else if (i < columns_.size() && columns_.TRANSID[i] == r->TRANSID)
+        columns_.erase(i);
+}
+
+const std::vector<wxString> Model_Checking::autocomplete(AUTOCOMPLETE_ID field, int64 account_id, size_t max)
+{
+    if (!autocomplete_loaded_)
+        autocomplete_load();
+
+    auto& ranked = autocomplete_.ranked[std::make_pair(static_cast<int>(field), account_id)];
+    if (ranked.empty())
+    {
+        std::vector<std::pair<Usage, const wxString*>> values;
+        for (const auto& [key, usage] : autocomplete_.values[field])
+        {
+            const auto it = usage.find(account_id);
+            if (it != usage.end())
+                values.emplace_back(it->second, &key.second);
+        }
+        std::stable_sort(values.begin(), values.end()
+            , [](const auto& a, const auto& b) { return a.first < b.first; });
+        ranked.reserve(values.size());
+        for (const auto& value : values)
+            ranked.push_back(*value.second);
+    }
+    return std::vector<wxString>(ranked.begin(), ranked.begin() + std::min(max, ranked.size()));
+}
+
+const std::vector<wxString> Model_Checking::autocomplete(AUTOCOMPLETE_ID field, const wxString& prefix
+    , int64 account_id, size_t max)
+{
+    if (prefix.IsEmpty())
+        return autocomplete(field, account_id, max);
+    if (!autocomplete_loaded_)
+        autocomplete_load();
+
+    const wxString lower = prefix.Lower();
+    const auto& values = autocomplete_.values[field];
+    std::vector<std::pair<Usage, const wxString*>> found;
+    for (auto it = values.lower_bound(std::make_pair(lower, wxString()))
+        ; it != values.end() && it->first.first.StartsWith(lower); ++it)
+    {
+        const auto usage = it->second.find(account_id);
+        if (usage != it->second.end())
+            found.emplace_back(usage->second, &it->first.second);
+    }
+
+    const size_t count = std::min(max, found.size());
+    std::partial_sort(found.begin(), found.begin() + count, found.end()
+        , [](const auto& a, const auto& b) { return a.first < b.first; });
+    std::vector<wxString> result;
+    result.reserve(count);
+    for (size_t i = 0; i < count; i++)
+        result.push_back(*found[i].second);
+    return result;
+}
+
+const std::map<wxString, Model_Checking::Usage> Model_Checking::autocomplete_usage(AUTOCOMPLETE_ID field, int64 account_id)
+{
+    if (!autocomplete_loaded_)
+        autocomplete_load();
+
+    std::map<wxString, Usage> result;
+    for (const auto& [key, usage] : autocomplete_.values[field])
+    {
+        const auto it = usage.find(account_id);
+        if (it != usage.end())
+            result[key.second] = it->second;
+    }
+    return result;
+}
+
+const Model_Checking::Usage_Map& Model_Checking::payee_usage(int64 account_id)
+{
+    if (!autocomplete_loaded_)
+        autocomplete_load();
+    return autocomplete_.payees[account_id];
+}
+
+void Model_Checking::autocomplete_reset()
+{
+    autocomplete_ = Autocomplete();
+    autocomplete_loaded_ = false;
+}
+
+/** Load the usage with one aggregate query per field, bypassing the Data cache */
+void Model_Checking::autocomplete_load()
+{
+    autocomplete_ = Autocomplete();
+    autocomplete_loaded_ = true;
+
+    const auto add = [](Usage& usage, int count, int day)
+    {
+        usage.count += count;
+        usage.last_day = std::max(usage.last_day, day);
+    };
+
+    try
+    {
+        const char* columns[AUTOCOMPLETE_size] = { "NOTES", "TRANSACTIONNUMBER" };
+        for (int field = 0; field < AUTOCOMPLETE_size; field++)
+        {
+            wxSQLite3ResultSet q = db_->ExecuteQuery(wxString::Format(
+                "SELECT ACCOUNTID, %1$s, COUNT(*), MAX(SUBSTR(TRANSDATE, 1, 10))"
+                " FROM CHECKINGACCOUNT_V1 WHERE %1$s <> '' GROUP BY ACCOUNTID, %1$s"
+                , columns[field]));
+            while (q.NextRow())
+            {
+                const wxString value = q.GetString(1);
+                Usage_Map& usage = autocomplete_.values[field][std::make_pair(value.Lower(), value)];
+                const int count = q.GetInt(2);
+                const int day = columns_day(q.GetString(3));
+                for (const int64 id : { q.GetInt64(0), int64(-1) })
+                    add(usage[id], count, day);
+            }
+            q.Finalize();
+        }
+
+        wxSQLite3ResultSet q = db_->ExecuteQuery(
+            "SELECT ACCOUNTID, PAYEEID, COUNT(*), MAX(SUBSTR(TRANSDATE, 1, 10))"
+            " FROM CHECKINGACCOUNT_V1 WHERE PAYEEID > 0 GROUP BY ACCOUNTID, PAYEEID"
+        );
+        while (q.NextRow())
+        {
+            const int64 account_id = q.GetInt64(0);
+            const int64 payee_id = q.GetInt64(1);
+            const int count = q.GetInt(2);
+            const int day = columns_day(q.GetString(3));
+            for (const int64 id : { account_id, int64(-1) })
+                add(autocomplete_.payees[id][payee_id], count, day);
+        }
+        q.Finalize();
+    }
+    catch (const wxSQLite3Exception &e)
+    {
+        wxLogError("CHECKINGACCOUNT_V1: Exception %s", e.GetMessage().utf8_str());
+        autocomplete_reset();
+    }
+}
+
+/**
+* Apply a saved (sign = 1) or removed (sign = -1) record to the loaded usage.
+* A removal does not move last_day back, the count alone decides when a value is gone.
+*/
+void Model_Checking::autocomplete_update(const Data* r, int sign)
+{
+    if (!autocomplete_loaded_)
+        return;
+
+    const int day = columns_day(r->TRANSDATE);
+    const wxString* values[AUTOCOMPLETE_size] = { &r->NOTES, &r->TRANSACTIONNUMBER };
+    for (int field = 0; field < AUTOCOMPLETE_size; field++)
+    {
+        if (values[field]->IsEmpty())
+            continue;
+
+        auto& index = autocomplete_.values[field];
+        const auto key = std::make_pair(values[field]->Lower(), *values[field]);
+        auto it = index.find(key);
+        if (it == index.end())
+        {
+            if (sign < 0)
+                continue;
+            it = index.emplace(key, Usage_Map()).first;
+        }
+        for (const int64 id : { r->ACCOUNTID, int64(-1) })
+            autocomplete_add(it->second, id, day, sign);
+        if (it->second.empty())
+            index.erase(it);
+
+        autocomplete_.ranked.erase(std::make_pair(field, r->ACCOUNTID));
+        autocomplete_.ranked.erase(std::make_pair(field, int64(-1)));
+    }
+
+    if (r->PAYEEID > 0)
+    {
+        for (const int64 id : { r->ACCOUNTID, int64(-1) })
+            autocomplete_add(autocomplete_.payees[id], r->PAYEEID, day, sign);
+    }
+}
+
+void Model_Checking::autocomplete_add(Usage_Map& usage, int64 key, int day, int sign)
+{
+    if (sign > 0)
+    {
+        Usage& u = usage[key];
+        u.count++;
+        u.last_day = std::max(u.last_day, day);
+        return;
+    }
+    const auto it = usage.find(key);
+    if (it != usage.end() && --it->second.count <= 0)
+        usage.erase(it);
+}
+
 void Model_Checking::updateTimestamp(int64 id)
 {
     Data* r = instance().get(id);
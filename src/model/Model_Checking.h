@@ -262,6 +262,94 @@ public:
     static bool foreignTransaction(const Data& data);
     static bool foreignTransactionAsTransfer(const Data& data);
 
+public:
+    /** Column-wise copy of the table for report aggregation, sorted by DAY and TRANSID */
+    struct Columns
+    {
+        std::vector<int64> TRANSID;
+        std::vector<int64> ACCOUNTID;
+        std::vector<int64> TOACCOUNTID;
+        std::vector<int64> PAYEEID;
+        std::vector<int64> CATEGID;
+        std::vector<int> DAY;               // TRANSDATE as ModelBase::to_day()
+        std::vector<unsigned char> TYPE;    // TYPE_ID
+        std::vector<unsigned char> STATUS;  // STATUS_ID
+        std::vector<unsigned char> DELETED; // DELETEDTIME is not empty
+        std::vector<double> TRANSAMOUNT;
+        std::vector<double> TOTRANSAMOUNT;
+
+        size_t size() const { return TRANSID.size(); }
+        /** Return the rows [first, last) with first_day <= DAY <= last_day */
+        std::pair<size_t, size_t> range(int first_day, int last_day) const;
+        /** Same as foreignTransactionAsTransfer() for row i */
+        bool foreign_as_transfer(size_t i) const;
+        /** Same as account_flow() for row i */
+        double account_flow(size_t i, int64 account_id) const;
+
+    private:
+        friend class Model_Checking;
+        void insert(size_t i, int day, const Data* r);
+        void erase(size_t i);
+        size_t lower_bound(int day, int64 id) const;
+    };
+
+    /** Return the column snapshot, loaded on first use and kept up to date by save() and remove() */
+    const Columns& columns();
+    void columns_reset();
+
+private:
+    Columns columns_;
+    bool columns_loaded_ = false;
+
+    void columns_load();
+    void columns_update(const Data* r, int sign);
+    static int columns_day(const wxString& date_iso);
+
+public:
+    enum AUTOCOMPLETE_ID { AUTOCOMPLETE_NOTES = 0, AUTOCOMPLETE_NUMBER, AUTOCOMPLETE_size };
+    /** How often a value is used and the latest day (ModelBase::to_day) it is used on */
+    struct Usage
+    {
+        int count = 0;
+        int last_day = 0;
+        /** More used first, then more recent */
+        bool operator<(const Usage& other) const
+        {
+            return count != other.count ? count > other.count : last_day > other.last_day;
+        }
+    };
+    typedef std::unordered_map<int64, Usage> Usage_Map;
+
+    /** Return up to max values of the field for the account (-1 for all), ordered by Usage */
+    const std::vector<wxString> autocomplete(AUTOCOMPLETE_ID field, int64 account_id = -1, size_t max = 20);
+    /** Same as above for the values starting with prefix, ignoring case */
+    const std::vector<wxString> autocomplete(AUTOCOMPLETE_ID field, const wxString& prefix
+        , int64 account_id = -1, size_t max = 20);
+    /** Return the value -> Usage map of the field for the account (-1 for all) */
+    const std::map<wxString, Usage> autocomplete_usage(AUTOCOMPLETE_ID field, int64 account_id);
+    /** Return the payee id -> Usage map for the account (-1 for all) */
+    const Usage_Map& payee_usage(int64 account_id = -1);
+    void autocomplete_reset();
+
+private:
+    // Usage per account, with -1 for all accounts, loaded on first use
+    // and kept up to date by save() and remove() like the column snapshot
+    struct Autocomplete
+    {
+        // (lower case value, value) -> account -> Usage, sorted for prefix queries
+        std::map<std::pair<wxString, wxString>, Usage_Map> values[AUTOCOMPLETE_size];
+        // account -> payee -> Usage
+        std::unordered_map<int64, Usage_Map> payees;
+        // (field, account) -> all values ordered by Usage, dropped when one of them changes
+        std::map<std::pair<int, int64>, std::vector<wxString>> ranked;
+    };
+    Autocomplete autocomplete_;
+    bool autocomplete_loaded_ = false;
+
+    void autocomplete_load();
+    void autocomplete_update(const Data* r, int sign);
+    static void autocomplete_add(Usage_Map& usage, int64 key, int day, int sign);
+
 public:
     static const wxString refTypeName;
 };
@@ -19,6 +19,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "Model_CurrencyHistory.h"
 #include "Model_Currency.h"
 #include "option.h"
+#include <algorithm>
 
 Model_CurrencyHistory::Model_CurrencyHistory()
     : Model<DB_Table_CURRENCYHISTORY_V1>()
@@ -38,6 +39,7 @@ Model_CurrencyHistory& Model_CurrencyHistory::instance(wxSQLite3Database* db)
     Model_CurrencyHistory& ins = Singleton<Model_CurrencyHistory>::instance();
     ins.db_ = db;
     ins.ensure(db);
+    ins.rate_series_reset();
 
     return ins;
 }
@@ -68,6 +70,18 @@ DB_Table_CURRENCYHISTORY_V1::CURRDATE Model_CurrencyHistory::CURRDATE(const wxDa
     return DB_Table_CURRENCYHISTORY_V1::CURRDATE(date.FormatISODate(), op);
 }
 
+int64 Model_CurrencyHistory::save(Data* r)
+{
+    rate_series_reset();
+    return Model<DB_Table_CURRENCYHISTORY_V1>::save(r);
+}
+
+bool Model_CurrencyHistory::remove(int64 id)
+{
+    rate_series_reset();
+    return Model<DB_Table_CURRENCYHISTORY_V1>::remove(id);
+}
+
 /**
 Adds or updates an element in stock history
 */
@@ -90,6 +104,11 @@ double Model_CurrencyHistory::getDayRate(int64 currencyID, const wxString& DateI
         auto c = Model_Currency::instance().get(currencyID);
         return c ? c->BASECONVRATE : 1.0;
     }
+
+    int day;
+    if (to_day(DateISO, day))
+        return Model_CurrencyHistory::getDayRate(currencyID, day);
+
     wxDate Date;
     if (Date.ParseDate(DateISO))
         return Model_CurrencyHistory::getDayRate(currencyID, Date);
@@ -101,6 +120,20 @@ double Model_CurrencyHistory::getDayRate(int64 currencyID, const wxString& DateI
 }
 
 double Model_CurrencyHistory::getDayRate(int64 currencyID, const wxDate& Date)
+{
+    return getDayRate(currencyID, to_day(Date));
+}
+
+std::vector<double> Model_CurrencyHistory::getDayRates(const std::vector<std::pair<int64, wxDate> >& items)
+{
+    std::vector<double> rates;
+    rates.reserve(items.size());
+    for (const auto& item : items)
+        rates.push_back(getDayRate(item.first, to_day(item.second)));
+    return rates;
+}
+
+double Model_CurrencyHistory::getDayRate(int64 currencyID, int day)
 {
     if (currencyID == Model_Currency::GetBaseCurrency()->CURRENCYID || currencyID == -1)
         return 1;
@@ -108,33 +141,19 @@ double Model_CurrencyHistory::getDayRate(int64 currencyID, const wxDate& Date)
     if (!Option::instance().getUseCurrencyHistory())
         return Model_Currency::instance().get(currencyID)->BASECONVRATE;
 
-    Model_CurrencyHistory::Data_Set Data = Model_CurrencyHistory::instance().find(Model_CurrencyHistory::CURRENCYID(currencyID), Model_CurrencyHistory::CURRDATE(Date));
-    if (!Data.empty())
-    {
-        //Rate found for specified day
-        return Data.back().CURRVALUE;
-    }
-    else if (Model_CurrencyHistory::instance().find(Model_CurrencyHistory::CURRENCYID(currencyID)).size() > 0)
+    const RateSeries* series = Model_CurrencyHistory::instance().rate_series(currencyID);
+    if (series)
     {
-        //Rate not found for specified day, look at previous and next
-        Model_CurrencyHistory::Data_Set DataPrevious = Model_CurrencyHistory::instance().find(Model_CurrencyHistory::CURRENCYID(currencyID), Model_CurrencyHistory::CURRDATE(Date, LESS_OR_EQUAL));
-        Model_CurrencyHistory::Data_Set DataNext = Model_CurrencyHistory::instance().find(Model_CurrencyHistory::CURRENCYID(currencyID), Model_CurrencyHistory::CURRDATE(Date, GREATER_OR_EQUAL));
-
-        if (!DataPrevious.empty() && !DataNext.empty())
-        {
-            const wxTimeSpan spanPast = Date.Subtract(Model::to_date(DataPrevious.back().CURRDATE));
-            const wxTimeSpan spanFuture = Model::to_date(DataNext[0].CURRDATE).Subtract(Date);
-
-            return spanPast <= spanFuture ? DataPrevious.back().CURRVALUE : DataNext[0].CURRVALUE;
-        }
-        else if (!DataPrevious.empty())
-        {
-            return DataPrevious.back().CURRVALUE;
-        }
-        else if (!DataNext.empty())
-        {
-            return DataNext[0].CURRVALUE;
-        }
+        // Rate of the specified day, otherwise the one of the nearest day (previous on a tie)
+        const auto next = std::lower_bound(series->days.begin(), series->days.end(), day);
+        const size_t i = next - series->days.begin();
+        if (next != series->days.end() && *next == day)
+            return series->rates[i];
+        if (i == 0)
+            return series->rates[0];
+        if (next == series->days.end())
+            return series->rates[i - 1];
+        return (day - series->days[i - 1] <= *next - day) ? series->rates[i - 1] : series->rates[i];
     }
 
     return Model_Currency::instance().get(currencyID)->BASECONVRATE;
@@ -146,11 +165,9 @@ double Model_CurrencyHistory::getLastRate(const int64& currencyID)
     if (!Option::instance().getUseCurrencyHistory())
         return Model_Currency::instance().get(currencyID)->BASECONVRATE;
 
-    Model_CurrencyHistory::Data_Set histData = Model_CurrencyHistory::instance().find(Model_CurrencyHistory::CURRENCYID(currencyID));
-    std::stable_sort(histData.begin(), histData.end(), SorterByCURRDATE());
-
-    if (!histData.empty())
-        return histData.back().CURRVALUE;
+    const RateSeries* series = Model_CurrencyHistory::instance().rate_series(currencyID);
+    if (series)
+        return series->rates.back();
     else
     {
         Model_Currency::Data* Currency = Model_Currency::instance().get(currencyID);
@@ -158,6 +175,47 @@ double Model_CurrencyHistory::getLastRate(const int64& currencyID)
     }
 }
 
+const Model_CurrencyHistory::RateSeries* Model_CurrencyHistory::rate_series(int64 currencyID)
+{
+    if (!rate_series_loaded_)
+        rate_series_load();
+
+    auto it = rate_series_.find(currencyID);
+    return it != rate_series_.end() ? &it->second : nullptr;
+}
+
+void Model_CurrencyHistory::rate_series_load()
+{
+    rate_series_.clear();
+    rate_series_loaded_ = true;
+
+    // one scan of the table; on a day with several rates the last saved one wins
+    Data_Set rows = this->all();
+    std::sort(rows.begin(), rows.end());
+    std::stable_sort(rows.begin(), rows.end(), SorterByCURRDATE());
+    for (const auto& r : rows)
+    {
+        int day;
+        if (!to_day(r.CURRDATE, day))
+            day = to_day(Model::to_date(r.CURRDATE));
+
+        RateSeries& series = rate_series_[r.CURRENCYID];
+        if (!series.days.empty() && series.days.back() == day)
+        {
+            series.rates.back() = r.CURRVALUE;
+            continue;
+        }
+        series.days.push_back(day);
+        series.rates.push_back(r.CURRVALUE);
+    }
+}
+
+void Model_CurrencyHistory::rate_series_reset()
+{
+    rate_series_.clear();
+    rate_series_loaded_ = false;
+}
+
 void Model_CurrencyHistory::ResetCurrencyHistory()
 {
     Model_CurrencyHistory::instance().Savepoint();
@@ -26,6 +26,8 @@ class Model_CurrencyHistory : public Model<DB_Table_CURRENCYHISTORY_V1>
 {
 public:
     using Model<DB_Table_CURRENCYHISTORY_V1>::get;
+    using Model<DB_Table_CURRENCYHISTORY_V1>::save;
+    using Model<DB_Table_CURRENCYHISTORY_V1>::remove;
     enum UPDTYPE { ONLINE = 1, MANUAL };
 
 public:
@@ -53,6 +55,12 @@ public:
 
     static DB_Table_CURRENCYHISTORY_V1::CURRDATE CURRDATE(const wxDate& date, OP op = EQUAL);
     
+    /** Save the record and drop the in-memory rate series */
+    int64 save(Data* r);
+
+    /** Remove the record and drop the in-memory rate series */
+    bool remove(int64 id);
+
     /** Adds or updates an element in currency history */
     int64 addUpdate(const int64 currencyID, const wxDate& date, double price, UPDTYPE type);
 
@@ -60,11 +68,31 @@ public:
     static double getDayRate(int64 currencyID, const wxString& DateISO);
     static double getDayRate(int64 currencyID, const wxDate& Date = wxDate::Today());
 
+    /** Return the rate for a specific currency in a day number, see ModelBase::to_day() */
+    static double getDayRate(int64 currencyID, int day);
+
+    /** Return the rates for a column of (currency, day) pairs, in the same order */
+    static std::vector<double> getDayRates(const std::vector<std::pair<int64, wxDate> >& items);
+
     /** Return the last rate for a specific currency */
     static double getLastRate(const int64& currencyID);
     
     /** Clears the currency History table */
     static void ResetCurrencyHistory();
+
+private:
+    /** Rate history of one currency sorted by day, days counted from 1970-01-01 */
+    struct RateSeries
+    {
+        std::vector<int> days;
+        std::vector<double> rates;
+    };
+    std::map<int64, RateSeries> rate_series_;
+    bool rate_series_loaded_ = false;
+
+    void rate_series_load();
+    void rate_series_reset();
+    const RateSeries* rate_series(int64 currencyID);
 };
 
 #endif // 
@@ -18,7 +18,8 @@
  ********************************************************/
 
 #include "Model_Payee.h"
-#include "Model_Checking.h" // detect whether the payee is used or not
+#include "Model_Category.h" // detect whether the payee is used or not
+#include "Model_Checking.h"
 #include "Model_Billsdeposits.h"
 
 Model_Payee::Model_Payee()
@@ -115,10 +116,10 @@ const std::map<wxString, int64> Model_Payee::used_payee()
         cache[p.PAYEEID] = p.PAYEENAME;
 
     std::map<wxString, int64> payees;
-    for (const auto &t : Model_Checking::instance().all())
+    for (const auto& [payee_id, usage] : Model_Checking::instance().payee_usage())
     {
-        if (cache.count(t.PAYEEID) > 0)
-            payees[cache[t.PAYEEID]] = t.PAYEEID;
+        if (cache.count(payee_id) > 0)
+            payees[cache[payee_id]] = payee_id;
     }
     for (const auto& b : Model_Billsdeposits::instance().all())
     {
@@ -153,17 +154,7 @@ bool Model_Payee::is_hidden(const Data& record)
 
 bool Model_Payee::is_used(int64 id)
 {
-    const auto &trans = Model_Checking::instance().find(Model_Checking::PAYEEID(id));
-    if (!trans.empty())
-    {
-        for (const auto& txn : trans)
-            if (txn.DELETEDTIME.IsEmpty())
-                return true;
-    }
-    const auto &bills = Model_Billsdeposits::instance().find(Model_Billsdeposits::PAYEEID(id));
-    if (!bills.empty()) return true;
-
-    return false;
+    return Model_Category::usage().payee_used(id);
 }
 
 bool Model_Payee::is_used(const Data* record)
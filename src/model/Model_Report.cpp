@@ -232,7 +232,7 @@ bool Model_Report::PrepareSQL(wxString& sql, std::map <wxString, wxString>& rep_
     return true;
 }
 
-int Model_Report::get_html(const Data* r, wxString& out)
+int Model_Report::get_html(const Data* r, wxString& out, const std::function<bool(int rows)>& progress)
 {
     wxString sql = r->SQLCONTENT;
     wxString templatecontent = r->TEMPLATECONTENT;
@@ -306,8 +306,16 @@ int Model_Report::get_html(const Data* r, wxString& out)
         //state.doString(R"(sys_locale=os.setlocale("", "numeric"); print(os.setlocale("C", "numeric"));)");
     }
 
+    int rows = 0;
     while (q.NextRow())
     {
+        if (progress && !progress(++rows))
+        {
+            q.Finalize();
+            out = _t("Report cancelled");
+            return -1;
+        }
+
         Record rec;
         for (int i = 0; i < columnCount; ++i)
         {
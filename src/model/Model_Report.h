@@ -19,6 +19,7 @@
 #ifndef MODEL_REPORT_H
 #define MODEL_REPORT_H
 
+#include <functional>
 #include "Model.h"
 #include "db/DB_Table_Report_V1.h"
 
@@ -49,7 +50,8 @@ public:
 public:
     bool get_objects_from_sql(const wxString& query, PrettyWriter<StringBuffer>& json_writer);
     wxArrayString allGroupNames();
-    int get_html(const Data* r, wxString& out);
+    /** progress is called with the rows read so far, a false return stops the report */
+    int get_html(const Data* r, wxString& out, const std::function<bool(int rows)>& progress = nullptr);
     //wxString get_html(const Data& r);
 
 public:
@@ -132,82 +132,117 @@ Returns the total stock balance at a given date
 */
 double Model_Stock::getDailyBalanceAt(const Model_Account::Data *account, const wxDate& date)
 {
-    wxString strDate = date.FormatISODate();
-    std::map<int64, double> totBalance;
+    const wxString strDate = date.FormatISODate();
+    const int day = to_day(date);
+    const bool account_open = Model_Account::status_id(account) == Model_Account::STATUS_ID_OPEN;
+    double balance = 0.0;
 
-    Data_Set stocks = this->instance().find(HELDAT(account->id()));
-    for (const auto & stock : stocks)
+    for (const auto& stock : find(HELDAT(account->id())))
     {
-        wxString precValueDate, nextValueDate;
-        Model_StockHistory::Data_Set stock_hist = Model_StockHistory::instance().find(SYMBOL(stock.SYMBOL));
-        std::stable_sort(stock_hist.begin(), stock_hist.end(), SorterByDATE());
-        std::reverse(stock_hist.begin(), stock_hist.end());
-
-        double valueAtDate = 0.0,  precValue = 0.0, nextValue = 0.0;
-
-        for (const auto & hist : stock_hist)
+        const Model_StockHistory::Series& hist = Model_StockHistory::instance().series(stock.SYMBOL);
+        double valueAtDate = 0.0, precValue = 0.0, nextValue = 0.0;
+        int precValueDay = 0, nextValueDay = 0;
+
+        // first price on or after the requested date
+        const size_t i = std::lower_bound(hist.DAY.begin(), hist.DAY.end(), day) - hist.DAY.begin();
+        const size_t next = (i < hist.DAY.size() && hist.DAY[i] == day) ? i + 1 : i;
+        if (next != i)
+            valueAtDate = hist.VALUE[i];
+        else if (i > 0 && hist.NONZERO[i - 1] >= 0)
         {
-            // test for the date requested
-            if (hist.DATE == strDate)
-            {
-                valueAtDate = hist.VALUE;
-                break;
-            }
-            // if not found, search for previous and next date
-            if (precValue == 0.0 && hist.DATE < strDate)
-            {
-                precValue = hist.VALUE;
-                precValueDate = hist.DATE;
-            }
-            if (hist.DATE > strDate)
-            {
-                nextValue = hist.VALUE;
-                nextValueDate = hist.DATE;
-            }
-            // end conditions: prec value assigned and price date < requested date
-            if (precValue != 0.0 && hist.DATE < strDate)
-                break;
+            precValue = hist.VALUE[hist.NONZERO[i - 1]];
+            precValueDay = hist.DAY[hist.NONZERO[i - 1]];
         }
+        if (next < hist.DAY.size())
+        {
+            nextValue = hist.VALUE[next];
+            nextValueDay = hist.DAY[next];
+        }
+
         if (valueAtDate == 0.0)
         {
+            const wxDate purchaseDate = PURCHASEDATE(stock);
+            const int purchaseDay = to_day(purchaseDate);
             //  if previous not found but if the given date is after purchase date, takes purchase price
-            if (precValue == 0.0 && date >= PURCHASEDATE(stock))
+            if (precValue == 0.0 && date >= purchaseDate)
             {
                 precValue = stock.PURCHASEPRICE;
-                precValueDate = stock.PURCHASEDATE;
+                precValueDay = purchaseDay;
             }
             //  if next not found and the accoung is open, takes previous date
-            if (nextValue == 0.0 && Model_Account::status_id(account) == Model_Account::STATUS_ID_OPEN)
+            if (nextValue == 0.0 && account_open)
             {
                 nextValue = precValue;
-                nextValueDate = precValueDate;
+                nextValueDay = precValueDay;
             }
-            if (precValue > 0.0 && nextValue > 0.0 && precValueDate >= stock.PURCHASEDATE && nextValueDate >= stock.PURCHASEDATE)
+            if (precValue > 0.0 && nextValue > 0.0 && precValueDay >= purchaseDay && nextValueDay >= purchaseDay)
                 valueAtDate = precValue;
         }
 
+        const Shares& steps = shares(stock.STOCKID);
         double numShares = 0.0;
+        if (steps.linked)
+            numShares = steps.at(day);
+        else if (stock.PURCHASEDATE <= strDate)
+            numShares = stock.NUMSHARES;
 
-        Model_Translink::Data_Set linkrecords = Model_Translink::TranslinkList<Model_Stock>(stock.STOCKID);
-        for (const auto& linkrecord : linkrecords)
-        {
-            Model_Checking::Data* txn = Model_Checking::instance().get(linkrecord.CHECKINGACCOUNTID);
-            if (txn->DELETEDTIME.IsEmpty() && Model_Checking::TRANSDATE(txn).FormatISODate() <= strDate) {
-                numShares += Model_Shareinfo::instance().ShareEntry(linkrecord.CHECKINGACCOUNTID)->SHARENUMBER;
-            }
-        }
+        balance += numShares * valueAtDate;
+    }
 
-        if (linkrecords.empty() && stock.PURCHASEDATE <= strDate)
-            numShares = stock.NUMSHARES;
+    return balance;
+}
+
+double Model_Stock::Shares::at(int day) const
+{
+    const size_t i = std::upper_bound(DAY.begin(), DAY.end(), day) - DAY.begin();
+    return i > 0 ? TOTAL[i - 1] : 0.0;
+}
 
-        totBalance[stock.id()] += numShares * valueAtDate;
+const Model_Stock::Shares& Model_Stock::shares(int64 stock_id)
+{
+    const std::array<size_t, 3> generation = {
+        Model_Translink::instance().generation(),
+        Model_Checking::instance().generation(),
+        Model_Shareinfo::instance().generation()
+    };
+    if (generation != shares_generation_)
+    {
+        shares_.clear();
+        shares_generation_ = generation;
     }
 
-    double balance = 0.0;
-    for (const auto& it : totBalance)
-        balance += it.second;
+    const auto it = shares_.find(stock_id);
+    if (it != shares_.end())
+        return it->second;
 
-    return balance;
+    const Model_Translink::Data_Set linkrecords = Model_Translink::TranslinkList<Model_Stock>(stock_id);
+    std::vector<std::pair<int, double>> changes;
+    for (const auto& linkrecord : linkrecords)
+    {
+        const Model_Checking::Data* txn = Model_Checking::instance().get(linkrecord.CHECKINGACCOUNTID);
+        if (!txn || !txn->DELETEDTIME.IsEmpty())
+            continue;
+        const Model_Shareinfo::Data* share = Model_Shareinfo::instance().ShareEntry(linkrecord.CHECKINGACCOUNTID);
+        changes.emplace_back(to_day(Model_Checking::TRANSDATE(txn)), share ? share->SHARENUMBER : 0.0);
+    }
+    std::stable_sort(changes.begin(), changes.end()
+        , [](const std::pair<int, double>& x, const std::pair<int, double>& y) { return x.first < y.first; });
+
+    Shares& s = shares_[stock_id];
+    s.linked = !linkrecords.empty();
+    double total = 0.0;
+    for (const auto& [change_day, number] : changes)
+    {
+        total += number;
+        if (!s.DAY.empty() && s.DAY.back() == change_day)
+            s.TOTAL.back() = total;
+        else
+        {
+            s.DAY.push_back(change_day);
+            s.TOTAL.push_back(total);
+        }
+    }
+    return s;
 }
 
 /**
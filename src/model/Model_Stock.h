@@ -23,6 +23,9 @@
 #include "Model.h"
 #include "db/DB_Table_Stock_V1.h"
 #include "Model_Account.h"
+#include <array>
+#include <map>
+#include <vector>
 
 class Model_Stock : public Model<DB_Table_STOCK_V1>
 {
@@ -90,6 +93,18 @@ public:
     */
     double getDailyBalanceAt(const Model_Account::Data *account, const wxDate& date);
 
+    /** Share count of a stock as a step function of the day */
+    struct Shares
+    {
+        bool linked = false;        // false when the stock has no share transactions
+        std::vector<int> DAY;       // ascending days of the active share transactions
+        std::vector<double> TOTAL;  // share count after each of them
+        double at(int day) const;
+    };
+
+    /** Return the share steps of the stock, cached until a share transaction changes */
+    const Shares& shares(int64 stock_id);
+
     /*
     stock_entry.PURCHASEPRICE = avg price of shares purchased.
     stock_entry.NUMSHARES = total amount of shares purchased.
@@ -100,6 +115,10 @@ public:
 
 public:
     static const wxString refTypeName;
+
+private:
+    std::map<int64, Shares> shares_;
+    std::array<size_t, 3> shares_generation_ = {};
 };
 
 #endif // 
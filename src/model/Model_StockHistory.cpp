@@ -37,6 +37,7 @@ Model_StockHistory& Model_StockHistory::instance(wxSQLite3Database* db)
     Model_StockHistory& ins = Singleton<Model_StockHistory>::instance();
     ins.db_ = db;
     ins.ensure(db);
+    ins.series_.clear();
 
     return ins;
 }
@@ -86,3 +87,65 @@ int64 Model_StockHistory::addUpdate(const wxString& symbol, const wxDate& date,
 
     return save(stockHist);
 }
+
+const Model_StockHistory::Series& Model_StockHistory::series(const wxString& symbol)
+{
+    if (series_generation_ != generation())
+        series_update();
+
+    const auto it = series_.find(symbol);
+    if (it != series_.end())
+        return it->second;
+
+    std::vector<std::pair<int, double>> prices;
+    for (const auto& hist : find(SYMBOL(symbol)))
+    {
+        series_symbol_[hist.HISTID] = hist.SYMBOL;
+        int day;
+        if (to_day(hist.DATE, day))
+            prices.emplace_back(day, hist.VALUE);
+    }
+    std::sort(prices.begin(), prices.end());
+
+    Series& s = series_[symbol];
+    s.DAY.reserve(prices.size());
+    s.VALUE.reserve(prices.size());
+    s.NONZERO.reserve(prices.size());
+    int nonzero = -1;
+    for (const auto& [day, value] : prices)
+    {
+        if (value != 0.0) nonzero = static_cast<int>(s.DAY.size());
+        s.DAY.push_back(day);
+        s.VALUE.push_back(value);
+        s.NONZERO.push_back(nonzero);
+    }
+    return s;
+}
+
+/** Drop the cached series touched by the changes since series_generation_, or all of them */
+void Model_StockHistory::series_update()
+{
+    std::vector<DB_Change> changes;
+    if (!changes_since(series_generation_, changes))
+    {
+        series_.clear();
+        series_symbol_.clear();
+    }
+
+    for (const auto& change : changes)
+    {
+        // an update may move the price to another symbol, drop both series
+        const auto it = series_symbol_.find(change.id);
+        if (it != series_symbol_.end())
+        {
+            series_.erase(it->second);
+            series_symbol_.erase(it);
+        }
+        if (change.type == DB_Change::CHANGE_REMOVE)
+            continue;
+        const Data* hist = get(change.id);
+        if (hist)
+            series_.erase(hist->SYMBOL);
+    }
+    series_generation_ = generation();
+}
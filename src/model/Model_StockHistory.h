@@ -21,6 +21,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include "Model.h"
 #include "db/DB_Table_Stockhistory_V1.h"
+#include <map>
+#include <vector>
 
 class Model_StockHistory : public Model<DB_Table_STOCKHISTORY_V1>
 {
@@ -56,6 +58,24 @@ public:
     Adds or updates an element in stock history
     */
     int64 addUpdate(const wxString& symbol, const wxDate& date, double price, UPDTYPE type);
+
+    /** Price history of a symbol in ascending day order */
+    struct Series
+    {
+        std::vector<int> DAY;
+        std::vector<double> VALUE;
+        std::vector<int> NONZERO; // position of the last nonzero price up to each entry, -1 if none
+    };
+
+    /** Return the price series of the symbol, cached until a price of the symbol changes */
+    const Series& series(const wxString& symbol);
+
+private:
+    std::map<wxString, Series> series_;
+    std::unordered_map<int64, wxString, DB_Id_Hash> series_symbol_; // history id -> symbol of a cached series
+    size_t series_generation_ = 0;
+
+    void series_update();
 };
 
 #endif // 
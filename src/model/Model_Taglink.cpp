@@ -70,6 +70,22 @@ std::map<wxString, int64> Model_Taglink::get(const wxString& refType, int64 refI
     return tags;
 }
 
+std::map<wxString, std::unordered_map<int64, std::set<wxString> > > Model_Taglink::get_names_all()
+{
+    std::unordered_map<int64, wxString> tagnames;
+    for (const auto& tag : Model_Tag::instance().all())
+        tagnames[tag.TAGID] = tag.TAGNAME;
+
+    std::map<wxString, std::unordered_map<int64, std::set<wxString> > > names;
+    for (const auto& link : instance().all())
+    {
+        const auto tag = tagnames.find(link.TAGID);
+        if (tag != tagnames.end())
+            names[link.REFTYPE][link.REFID].insert(tag->second);
+    }
+    return names;
+}
+
 /* Delete all tags for a REFTYPE + REFID */
 void Model_Taglink::DeleteAllTags(const wxString& refType, int64 refID)
 {
@@ -21,6 +21,8 @@
 
 #include "Model.h"
 #include "db/DB_Table_Taglink_V1.h"
+#include <set>
+#include <unordered_map>
 
 class Model_Taglink : public Model<DB_Table_TAGLINK_V1>
 {
@@ -62,6 +64,12 @@ public:
     */
     std::map<wxString, int64> get(const wxString& refType, int64 refId);
 
+    /**
+    * Return the tag names of all tagged records, keyed by REFTYPE and REFID
+    * Loaded with one scan of the table, for filters that test many records
+    */
+    std::map<wxString, std::unordered_map<int64, std::set<wxString> > > get_names_all();
+
     /* Delete all tags for a REFTYPE + REFID */
     void DeleteAllTags(const wxString& refType, int64 refID);
 
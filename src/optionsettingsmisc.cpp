@@ -202,6 +202,12 @@ void OptionSettingsMisc::Create()
         "create or update the backup database: dbFile_update_YYYY-MM-DD.bak"));
     databaseStaticBoxSizer->Add(databaseUpdateCheckBox, g_flagsV);
 
+    wxCheckBox* databaseCompressCheckBox = new wxCheckBox(misc_panel, ID_DIALOG_OPTIONS_CHK_BACKUP_COMPRESS
+        , _t("Compress backups"), wxDefaultPosition, wxDefaultSize, wxCHK_2STATE);
+    databaseCompressCheckBox->SetValue(GetIniDatabaseCheckboxValue("BACKUPDB_COMPRESS", false));
+    databaseCompressCheckBox->SetToolTip(_t("Store the backups of unencrypted databases gzip compressed: dbFile_start_YYYY-MM-DD.bak.gz"));
+    databaseStaticBoxSizer->Add(databaseCompressCheckBox, g_flagsV);
+
     int max = Model_Setting::instance().getInt("MAX_BACKUP_FILES", 4);
     m_max_files = new wxSpinCtrl(misc_panel, wxID_ANY
         , wxEmptyString, wxDefaultPosition, wxDefaultSize, wxSP_ARROW_KEYS, 1, 999, max);
@@ -302,6 +308,9 @@ bool OptionSettingsMisc::SaveSettings()
     wxCheckBox* itemCheckBoxUpdate = static_cast<wxCheckBox*>(FindWindow(ID_DIALOG_OPTIONS_CHK_BACKUP_UPDATE));
     Model_Setting::instance().setBool("BACKUPDB_UPDATE", itemCheckBoxUpdate->GetValue());
 
+    wxCheckBox* itemCheckBoxCompress = static_cast<wxCheckBox*>(FindWindow(ID_DIALOG_OPTIONS_CHK_BACKUP_COMPRESS));
+    Model_Setting::instance().setBool("BACKUPDB_COMPRESS", itemCheckBoxCompress->GetValue());
+
     Model_Setting::instance().setInt("MAX_BACKUP_FILES", m_max_files->GetValue());
     Model_Setting::instance().setInt("DELETED_TRANS_RETAIN_DAYS", m_deleted_trans_retain_days->GetValue());
     Model_Setting::instance().setBool("REFRESH_STOCK_QUOTES_ON_OPEN", m_refresh_quotes_on_open->IsChecked());
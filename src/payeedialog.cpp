@@ -605,19 +605,34 @@ void mmPayeeDialog::fillControls()
     payee_idx_map_.clear();
     m_payee_id = -1;
     
-    Model_Payee::Data_Set payees = Model_Payee::instance().FilterPayees(m_maskStr);
+    // typing into the filter only re-reads the payees after they changed
+    if (m_payees_generation != Model_Payee::instance().generation())
+    {
+        m_payees = Model_Payee::instance().all(Model_Payee::COL_PAYEENAME);
+        m_payees_generation = Model_Payee::instance().generation();
+    }
+    const Model_Category::Usage& usage = Model_Category::usage();
+
+    const wxString mask = m_maskStr.Lower().Append("*");
+    Model_Payee::Data_Set payees;
+    for (const auto& payee : m_payees)
+    {
+        if (payee.PAYEENAME.Lower().Matches(mask))
+            payees.push_back(payee);
+    }
+
     switch (m_sort)
     {
     case PAYEE_HIDDEN:
         std::stable_sort(payees.begin(), payees.end(), SorterByACTIVE());
         break;    
     case PAYEE_CATEGORY:
-        std::stable_sort(payees.begin(), payees.end(), [] (Model_Payee::Data x, Model_Payee::Data y)
+        std::stable_sort(payees.begin(), payees.end(), [&usage] (const Model_Payee::Data& x, const Model_Payee::Data& y)
         {
             return(
                 CaseInsensitiveLocaleCmp(
-                    Model_Category::instance().full_name(x.CATEGID)
-                    , Model_Category::instance().full_name(y.CATEGID)) < 0
+                    usage.category_name(x.CATEGID)
+                    , usage.category_name(y.CATEGID)) < 0
                 );
         });
         break;  
@@ -649,7 +664,7 @@ void mmPayeeDialog::fillControls()
         item.SetId(idx);
         payee_idx_map_[idx] = payee.PAYEEID.GetValue();
         payeeListBox_->InsertItem(item);
-        const wxString full_category_name = Model_Category::instance().full_name(payee.CATEGID);
+        const wxString& full_category_name = usage.category_name(payee.CATEGID);
         payeeListBox_->SetItem(idx, 0, payee.PAYEENAME);
         if (!m_init_selected_payee.IsEmpty() && payee.PAYEENAME.CmpNoCase(m_init_selected_payee) == 0) {
             payeeListBox_->Select(idx);
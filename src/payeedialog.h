@@ -112,6 +112,8 @@ private:
     bool refreshRequested_ = false, m_sortReverse = false;
     std::map<int, wxString> ColName_;
     std::map<long, int64> payee_idx_map_;
+    Model_Payee::Data_Set m_payees;
+    size_t m_payees_generation = static_cast<size_t>(-1);
 
 private:
     mmPayeeDialog() {}
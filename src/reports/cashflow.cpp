@@ -26,6 +26,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "model/Model_Account.h"
 #include "model/Model_Billsdeposits.h"
 #include "model/Model_CurrencyHistory.h"
+#include <climits>
 
 // --------- CashFlow base class
 
@@ -77,6 +78,7 @@ void mmReportCashFlow::getTransactions()
     wxDateTime endDate = mmDateRange::getDayEnd(m_today.Add(wxDateSpan::Months(getForwardMonths())));
 
     // Get initial Balance as of today
+    std::map<int64, double> accountRate;
     for (const auto& account : Model_Account::instance().find(
         Model_Account::ACCOUNTTYPE(Model_Account::TYPE_NAME_INVESTMENT, NOT_EQUAL),
         Model_Account::STATUS(Model_Account::STATUS_ID_CLOSED, NOT_EQUAL)
@@ -87,15 +89,28 @@ void mmReportCashFlow::getTransactions()
 
         double convRate = Model_CurrencyHistory::getDayRate(account.CURRENCYID, todayString);
         m_balance += account.INITIALBAL * convRate;
+        accountRate[account.ACCOUNTID] = convRate;
 
         m_account_id.push_back(account.ACCOUNTID);
+    }
 
-        for (const auto& tran : Model_Account::transactionsByDateTimeId(account)) {
-            wxString strDate = Model_Checking::TRANSDATE(tran).FormatISOCombined();
-            // Do not include asset or stock transfers in income expense calculations.
-            if (Model_Checking::foreignTransactionAsTransfer(tran) || (strDate > todayString))
-                continue;
-            m_balance += Model_Checking::account_flow(tran, account.ACCOUNTID) * convRate;
+    const auto& tran = Model_Checking::instance().columns();
+    const int today = Model_Checking::to_day(m_today);
+    const auto rows = tran.range(INT_MIN, today);
+    for (size_t i = rows.first; i < rows.second; i++) {
+        // Do not include asset or stock transfers in income expense calculations.
+        if (tran.foreign_as_transfer(i))
+            continue;
+        // Later today belongs to the forecast below when m_today carries the current time
+        if (tran.DAY[i] == today
+            && Model_Checking::TRANSDATE(Model_Checking::instance().get(tran.TRANSID[i])).FormatISOCombined() > todayString)
+            continue;
+        for (int64 account_id : { tran.ACCOUNTID[i], tran.TOACCOUNTID[i] }) {
+            const auto account = accountRate.find(account_id);
+            if (account != accountRate.end())
+                m_balance += tran.account_flow(i, account_id) * account->second;
+            if (tran.ACCOUNTID[i] == tran.TOACCOUNTID[i])
+                break;
         }
     }
 
@@ -127,22 +142,12 @@ void mmReportCashFlow::getTransactions()
     }
 
     // Now we gather the recurring transaction list
+    const int end_day = Model_Billsdeposits::to_day(endDate);
     for (const auto& entry : Model_Billsdeposits::instance().find(
         Model_Billsdeposits::STATUS(Model_Checking::STATUS_ID_VOID, NOT_EQUAL)
     )) {
-        wxDateTime nextOccurDate = Model_Billsdeposits::NEXTOCCURRENCEDATE(entry);
-        if (nextOccurDate > endDate) continue;
-
-        // demultiplex entry.REPEATS
-        int repeats = entry.REPEATS.GetValue() % BD_REPEATS_MULTIPLEX_BASE;
-        int numRepeats = entry.NUMOCCURRENCES.GetValue();
-
-        // ignore old inactive entries
-        if (repeats >= Model_Billsdeposits::REPEAT_IN_X_DAYS && repeats <= Model_Billsdeposits::REPEAT_EVERY_X_MONTHS && numRepeats == -1)
-            continue;
-
-        // ignore invalid entries
-        if (repeats != Model_Billsdeposits::REPEAT_ONCE && (numRepeats == 0 || numRepeats < -1))
+        int first_day;
+        if (!Model_Billsdeposits::to_day(entry.NEXTOCCURRENCEDATE, first_day) || first_day > end_day)
             continue;
 
         bool isAccountFound = std::find(m_account_id.begin(), m_account_id.end(), entry.ACCOUNTID) != m_account_id.end();
@@ -151,11 +156,11 @@ void mmReportCashFlow::getTransactions()
             continue; // skip account
 
         // Process all possible recurring transactions for this BD
-        while (1) {
-            if (nextOccurDate > endDate) break;
-
+        const auto splits = Model_Billsdeposits::split(entry);
+        const auto occurrences = Model_Billsdeposits::instance().timeline(&entry, first_day).range(first_day, end_day);
+        for (auto day = occurrences.first; day != occurrences.second; ++day) {
             Model_Checking::Data trx;
-            trx.TRANSDATE = nextOccurDate.FormatISODate();
+            trx.TRANSDATE = Model_Billsdeposits::day_iso(*day);
             trx.ACCOUNTID = entry.ACCOUNTID;
             trx.TOACCOUNTID = entry.TOACCOUNTID;
             trx.PAYEEID =  entry.PAYEEID;
@@ -163,7 +168,7 @@ void mmReportCashFlow::getTransactions()
             trx.TRANSAMOUNT = entry.TRANSAMOUNT;
             trx.TOTRANSAMOUNT = entry.TOTRANSAMOUNT;
             if (entry.CATEGID == -1) {
-                for (const auto& split_item : Model_Billsdeposits::split(entry)) {
+                for (const auto& split_item : splits) {
                     trx.CATEGID = split_item.CATEGID;
                     trx.TRANSAMOUNT = split_item.SPLITTRANSAMOUNT;
                     trx.TRANSAMOUNT = trueAmount(trx);
@@ -175,23 +180,6 @@ void mmReportCashFlow::getTransactions()
                 trx.TRANSAMOUNT = trueAmount(trx);
                 m_forecastVector.push_back(trx);
             }
-
-            if ((repeats == Model_Billsdeposits::REPEAT_ONCE) || ((repeats < Model_Billsdeposits::REPEAT_IN_X_DAYS || repeats > Model_Billsdeposits::REPEAT_EVERY_X_MONTHS) && numRepeats == 1))
-                break;
-
-            nextOccurDate = Model_Billsdeposits::nextOccurDate(repeats, numRepeats, nextOccurDate);
-
-            if ((repeats < Model_Billsdeposits::REPEAT_IN_X_DAYS || repeats > Model_Billsdeposits::REPEAT_EVERY_X_MONTHS) &&
-                numRepeats > 1
-            ) {
-                numRepeats--;
-            }
-            else if (repeats >= Model_Billsdeposits::REPEAT_IN_X_DAYS &&
-                repeats <= Model_Billsdeposits::REPEAT_IN_X_MONTHS
-            ) {
-                // change repeat type to REPEAT_ONCE
-                repeats = Model_Billsdeposits::REPEAT_ONCE;
-            }
         }
     }
 
@@ -41,21 +41,22 @@ mmReportCategoryExpenses::~mmReportCategoryExpenses()
 {
 }
 
-double mmReportCategoryExpenses::AppendData(const std::vector<mmReportCategoryExpenses::data_holder> &data, std::map<int64, std::map<int, double>> &categoryStats, const DB_Table_CATEGORY_V1::Data* category, int64 groupID, int level) {
-    double amt = categoryStats[category->CATEGID][0];
-    if (type_ == COME && amt < 0.0) amt = 0;
-    if (type_ == GOES && amt > 0.0) amt = 0;
+void mmReportCategoryExpenses::AppendData(std::map<int64, std::map<int, double>>& categoryStats
+    , std::map<int64, std::map<int, double>>& categoryTotals
+    , const DB_Table_CATEGORY_V1::Data* category, int64 groupID, int level)
+{
+    const double amt = categoryStats[category->CATEGID][0];
+    // rows are inserted at the front, so the subcategories are visited in reverse name order
     Model_Category::Data_Set subcategories = Model_Category::sub_category(category);
-    std::stable_sort(subcategories.begin(), subcategories.end(), SorterByCATEGNAME());
     std::reverse(subcategories.begin(), subcategories.end());
     double subamount = 0;
     for (const auto& subcategory : subcategories) {
-        double amount = AppendData(data_, categoryStats, &subcategory, groupID, level + 1);
+        AppendData(categoryStats, categoryTotals, &subcategory, groupID, level + 1);
+        const double amount = categoryTotals[subcategory.CATEGID][0];
         if (amount != 0) data_.insert(data_.begin(), { category->CATEGID, subcategory.CATEGID, category->CATEGNAME, amount, groupID, level });
         subamount += amount;
     }
     if (amt != 0 || subamount != 0) data_.insert(data_.begin(), { category->CATEGID, -1, category->CATEGNAME, amt, groupID, level });
-    return amt + subamount;
 }
 
 void  mmReportCategoryExpenses::RefreshData()
@@ -68,30 +69,22 @@ void  mmReportCategoryExpenses::RefreshData()
         , Option::instance().getIgnoreFutureTransactions()
         , false);
 
-    data_holder line;
-    int groupID = 0;
+    // keep the side of the report, then total each category with its subcategories
+    for (auto& stat : categoryStats)
+    {
+        double& amt = stat.second[0];
+        if (type_ == COME && amt < 0.0) amt = 0;
+        if (type_ == GOES && amt > 0.0) amt = 0;
+    }
+    std::map<int64, std::map<int, double> > categoryTotals = categoryStats;
+    Model_Category::rollupCategoryStats(categoryTotals);
+
     Model_Category::Data_Set categories = Model_Category::instance().find(Model_Category::PARENTID(-1));
     std::stable_sort(categories.begin(), categories.end(), SorterByCATEGNAME());
     std::reverse(categories.begin(), categories.end());
     for (const auto& category : categories)
     {
-        double amt = categoryStats[category.CATEGID][0];
-        if (type_ == COME && amt < 0.0) amt = 0;
-        if (type_ == GOES && amt > 0.0) amt = 0;
-        
-        auto subcategories = Model_Category::sub_category(category);
-        std::stable_sort(subcategories.begin(), subcategories.end(), SorterByCATEGNAME());
-        std::reverse(subcategories.begin(), subcategories.end());
-        double subamount = 0;
-        for (const auto& sub_category : subcategories)
-        {
-            double amount = AppendData(data_, categoryStats, &sub_category, category.CATEGID, 1);
-            if (amount != 0) data_.insert(data_.begin(), { category.CATEGID, sub_category.CATEGID, category.CATEGNAME, amount, category.CATEGID, 0 });
-            subamount += amount;
-        }
-        if (amt != 0 || subamount != 0) data_.insert(data_.begin(), { category.CATEGID, -1, category.CATEGNAME, amt, category.CATEGID, 0 });
-
-        groupID++;
+        AppendData(categoryStats, categoryTotals, &category, category.CATEGID, 0);
     }
 }
 
@@ -36,7 +36,7 @@ public:
     virtual ~mmReportCategoryExpenses();
 
     virtual void RefreshData();
-    double AppendData(const std::vector<data_holder>& data, std::map<int64, std::map<int, double>>& categoryStats,
+    void AppendData(std::map<int64, std::map<int, double>>& categoryStats, std::map<int64, std::map<int, double>>& categoryTotals,
         const DB_Table_CATEGORY_V1::Data* category, int64 groupID, int level);
     virtual wxString getHTMLText();
 
@@ -39,28 +39,31 @@ mmReportForecast::~mmReportForecast()
 wxString mmReportForecast::getHTMLText()
 {
     // Grab the data
-    std::map<wxString, std::pair<double, double> > amount_by_day;
-    Model_Checking::Data_Set all_trans;
-    
+    std::map<int, std::pair<double, double> > amount_by_day;
+    const auto accountCurrency = getAccountCurrencies(false);
+    const auto& tran = Model_Checking::instance().columns();
+    std::pair<size_t, size_t> rows(0, tran.size());
     if (m_date_range && m_date_range->is_with_date()) {
-        all_trans = Model_Checking::instance().find(Model_Checking::TRANSDATE(m_date_range->start_date(), GREATER_OR_EQUAL),
-                                                    Model_Checking::TRANSDATE(m_date_range->end_date().FormatISOCombined(), LESS_OR_EQUAL));
-    }
-    else {
-        all_trans = Model_Checking::instance().all();
+        rows = tran.range(
+            Model_Checking::to_day(m_date_range->start_date()),
+            Model_Checking::to_day(m_date_range->end_date())
+        );
     }
 
-    for (const auto & trx : all_trans)
+    for (size_t i = rows.first; i < rows.second; i++)
     {
-        if (Model_Checking::type_id(trx) == Model_Checking::TYPE_ID_TRANSFER || Model_Checking::foreignTransactionAsTransfer(trx))
+        if (tran.TYPE[i] == Model_Checking::TYPE_ID_TRANSFER || tran.foreign_as_transfer(i))
+            continue;
+        const auto account = accountCurrency.find(tran.ACCOUNTID[i]);
+        if (account == accountCurrency.end())
             continue;
-        const double convRate = Model_CurrencyHistory::getDayRate(Model_Account::instance().get(trx.ACCOUNTID)->CURRENCYID, trx.TRANSDATE);
-        amount_by_day[trx.TRANSDATE].first += Model_Checking::account_outflow(trx, trx.ACCOUNTID) * convRate;
-        amount_by_day[trx.TRANSDATE].second += Model_Checking::account_inflow(trx, trx.ACCOUNTID) * convRate;
+        const double convRate = Model_CurrencyHistory::getDayRate(account->second, tran.DAY[i]);
+        const double flow = tran.account_flow(i, tran.ACCOUNTID[i]) * convRate;
+        auto& amount = amount_by_day[tran.DAY[i]];
+        if (flow <= 0) amount.first -= flow;
+        if (flow >= 0) amount.second += flow;
     }
 
-    
-
     // Build the report
     mmHTMLBuilder hb;
     hb.init();
@@ -71,7 +74,9 @@ wxString mmReportForecast::getHTMLText()
     GraphSeries gsWithdrawal, gsDeposit;
     for (const auto & kv : amount_by_day)
     {
-        gd.labels.push_back(kv.first);
+        int year, month, day;
+        Model_Checking::from_day(kv.first, year, month, day);
+        gd.labels.push_back(wxString::Format("%04d-%02d-%02d", year, month, day));
         //wxLogDebug(" Values = %d, %d", kv.second.first, kv.second.second);
         gsWithdrawal.values.push_back(kv.second.first);
         gsDeposit.values.push_back(kv.second.second);
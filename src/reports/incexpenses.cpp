@@ -45,29 +45,27 @@ wxString mmReportIncomeExpenses::getHTMLText()
 {
     // Grab the data
     std::pair<double, double> income_expenses_pair;
-    for (const auto& transaction : Model_Checking::instance().find(
-        Model_Checking::TRANSDATE(m_date_range->start_date(), GREATER_OR_EQUAL)
-        , Model_Checking::TRANSDATE(m_date_range->end_date().FormatISOCombined(), LESS_OR_EQUAL)
-        , Model_Checking::STATUS(Model_Checking::STATUS_ID_VOID, NOT_EQUAL)))
+    const auto accountCurrency = getAccountCurrencies();
+    const auto& tran = Model_Checking::instance().columns();
+    const auto rows = tran.range(
+        Model_Checking::to_day(m_date_range->start_date()),
+        Model_Checking::to_day(m_date_range->end_date())
+    );
+    for (size_t i = rows.first; i < rows.second; i++)
     {
-        // Do not include asset or stock transfers or deleted transactions in income expense calculations.
-        if (Model_Checking::foreignTransactionAsTransfer(transaction) || !transaction.DELETEDTIME.IsEmpty())
+        // Do not include void or deleted transactions, or asset or stock transfers in income expense calculations.
+        if (tran.STATUS[i] == Model_Checking::STATUS_ID_VOID || tran.DELETED[i] || tran.foreign_as_transfer(i))
             continue;
 
-        Model_Account::Data *account = Model_Account::instance().get(transaction.ACCOUNTID);
-        if (accountArray_)
-        {
-            if (!account || wxNOT_FOUND == accountArray_->Index(account->ACCOUNTNAME))
-                continue;
-        }
-        double convRate = 1;
-        // We got this far, get the currency conversion rate for this account
-        if (account) convRate = Model_CurrencyHistory::getDayRate(Model_Account::currency(account)->CURRENCYID, transaction.TRANSDATE);
-
-        if (Model_Checking::type_id(transaction) == Model_Checking::TYPE_ID_DEPOSIT)
-            income_expenses_pair.first += transaction.TRANSAMOUNT * convRate;
-        else if (Model_Checking::type_id(transaction) == Model_Checking::TYPE_ID_WITHDRAWAL)
-            income_expenses_pair.second += transaction.TRANSAMOUNT * convRate;
+        const auto account = accountCurrency.find(tran.ACCOUNTID[i]);
+        if (account == accountCurrency.end())
+            continue;
+        const double convRate = Model_CurrencyHistory::getDayRate(account->second, tran.DAY[i]);
+
+        if (tran.TYPE[i] == Model_Checking::TYPE_ID_DEPOSIT)
+            income_expenses_pair.first += tran.TRANSAMOUNT[i] * convRate;
+        else if (tran.TYPE[i] == Model_Checking::TYPE_ID_WITHDRAWAL)
+            income_expenses_pair.second += tran.TRANSAMOUNT[i] * convRate;
     }
 
     // Build the report
@@ -145,33 +143,32 @@ wxString mmReportIncomeExpensesMonthly::getHTMLText()
     const wxDateTime start_date = m_date_range->start_date();
     std::map<int, std::pair<double, double> > incomeExpensesStats;
     //TODO: init all the map values with 0.0
-    for (const auto& transaction : Model_Checking::instance().find(
-        Model_Checking::TRANSDATE(start_date, GREATER_OR_EQUAL)
-        , Model_Checking::TRANSDATE(m_date_range->end_date().FormatISOCombined(), LESS_OR_EQUAL)
-        , Model_Checking::STATUS(Model_Checking::STATUS_ID_VOID, NOT_EQUAL)))
+    const auto accountCurrency = getAccountCurrencies();
+    const auto& tran = Model_Checking::instance().columns();
+    const auto rows = tran.range(
+        Model_Checking::to_day(start_date),
+        Model_Checking::to_day(m_date_range->end_date())
+    );
+    for (size_t i = rows.first; i < rows.second; i++)
     {
-        // Do not include asset or stock transfers or deleted transactions in income expense calculations.
-        if (Model_Checking::foreignTransactionAsTransfer(transaction) || !transaction.DELETEDTIME.IsEmpty())
+        // Do not include void or deleted transactions, or asset or stock transfers in income expense calculations.
+        if (tran.STATUS[i] == Model_Checking::STATUS_ID_VOID || tran.DELETED[i] || tran.foreign_as_transfer(i))
             continue;
 
-        Model_Account::Data *account = Model_Account::instance().get(transaction.ACCOUNTID);
-        if (accountArray_)
-        {
-            if (!account || wxNOT_FOUND == accountArray_->Index(account->ACCOUNTNAME))
-                continue;
-        }
-        double convRate = 1;
-        // We got this far, get the currency conversion rate for this account
-        if (account) convRate = Model_CurrencyHistory::getDayRate(Model_Account::currency(account)->CURRENCYID, transaction.TRANSDATE);
-        int year = Model_Checking::TRANSDATE(transaction).GetYear();
+        const auto account = accountCurrency.find(tran.ACCOUNTID[i]);
+        if (account == accountCurrency.end())
+            continue;
+        const double convRate = Model_CurrencyHistory::getDayRate(account->second, tran.DAY[i]);
 
-        int idx = year * 100 + Model_Checking::TRANSDATE(transaction).GetMonth();
+        int year, month, day;
+        Model_Checking::from_day(tran.DAY[i], year, month, day);
+        int idx = year * 100 + month - 1;
 
-        if (Model_Checking::type_id(transaction) == Model_Checking::TYPE_ID_DEPOSIT) {
-            incomeExpensesStats[idx].first += transaction.TRANSAMOUNT * convRate;
+        if (tran.TYPE[i] == Model_Checking::TYPE_ID_DEPOSIT) {
+            incomeExpensesStats[idx].first += tran.TRANSAMOUNT[i] * convRate;
         }
-        else if (Model_Checking::type_id(transaction) == Model_Checking::TYPE_ID_WITHDRAWAL) {
-            incomeExpensesStats[idx].second += transaction.TRANSAMOUNT * convRate;
+        else if (tran.TYPE[i] == Model_Checking::TYPE_ID_WITHDRAWAL) {
+            incomeExpensesStats[idx].second += tran.TRANSAMOUNT[i] * convRate;
         }
     }
 
@@ -184,47 +184,54 @@ void mmReportPayeeExpenses::getPayeeStats(std::map<int64, std::pair<double, doub
                                           , mmDateRange* date_range, bool WXUNUSED(ignoreFuture)) const
 {
 // FIXME: do not ignore ignoreFuture param
-    const auto &transactions = Model_Checking::instance().find(
-        Model_Checking::STATUS(Model_Checking::STATUS_ID_VOID, NOT_EQUAL)
-        , Model_Checking::TRANSDATE(date_range->start_date(), GREATER_OR_EQUAL)
-        , Model_Checking::TRANSDATE(date_range->end_date().FormatISOCombined(), LESS_OR_EQUAL));
+    const auto accountCurrency = getAccountCurrencies(false);
+    const auto& tran = Model_Checking::instance().columns();
+    const auto rows = tran.range(
+        Model_Checking::to_day(date_range->start_date()),
+        Model_Checking::to_day(date_range->end_date())
+    );
     const auto all_splits = Model_Splittransaction::instance().get_all();
-    for (const auto& trx: transactions)
+    for (size_t i = rows.first; i < rows.second; i++)
     {
-        if (Model_Checking::type_id(trx) == Model_Checking::TYPE_ID_TRANSFER || !trx.DELETEDTIME.IsEmpty()) continue;
+        if (tran.STATUS[i] == Model_Checking::STATUS_ID_VOID || tran.DELETED[i]) continue;
+        if (tran.TYPE[i] == Model_Checking::TYPE_ID_TRANSFER) continue;
 
         // Do not include asset or stock transfers in income expense calculations.
-        if (Model_Checking::foreignTransactionAsTransfer(trx))
+        if (tran.foreign_as_transfer(i))
             continue;
 
-        const double convRate = Model_CurrencyHistory::getDayRate(Model_Account::instance().get(trx.ACCOUNTID)->CURRENCYID, trx.TRANSDATE);
+        const auto account = accountCurrency.find(tran.ACCOUNTID[i]);
+        if (account == accountCurrency.end())
+            continue;
+        const double convRate = Model_CurrencyHistory::getDayRate(account->second, tran.DAY[i]);
+        const bool is_deposit = tran.TYPE[i] == Model_Checking::TYPE_ID_DEPOSIT;
+        const int64 payee_id = tran.PAYEEID[i];
 
-        Model_Splittransaction::Data_Set splits;
-        if (all_splits.count(trx.id())) splits = all_splits.at(trx.id());
-        if (splits.empty())
+        const auto splits = all_splits.find(tran.TRANSID[i]);
+        if (splits == all_splits.end() || splits->second.empty())
         {
-            if (Model_Checking::type_id(trx) == Model_Checking::TYPE_ID_DEPOSIT)
-                payeeStats[trx.PAYEEID].first += trx.TRANSAMOUNT * convRate;
+            if (is_deposit)
+                payeeStats[payee_id].first += tran.TRANSAMOUNT[i] * convRate;
             else
-                payeeStats[trx.PAYEEID].second -= trx.TRANSAMOUNT * convRate;
+                payeeStats[payee_id].second -= tran.TRANSAMOUNT[i] * convRate;
         }
         else
         {
-            for (const auto& entry : splits)
+            for (const auto& entry : splits->second)
             {
-                if (Model_Checking::type_id(trx) == Model_Checking::TYPE_ID_DEPOSIT)
+                if (is_deposit)
                 {
                     if (entry.SPLITTRANSAMOUNT >= 0)
-                        payeeStats[trx.PAYEEID].first += entry.SPLITTRANSAMOUNT * convRate;
+                        payeeStats[payee_id].first += entry.SPLITTRANSAMOUNT * convRate;
                     else
-                        payeeStats[trx.PAYEEID].second += entry.SPLITTRANSAMOUNT * convRate;
+                        payeeStats[payee_id].second += entry.SPLITTRANSAMOUNT * convRate;
                 }
                 else
                 {
                     if (entry.SPLITTRANSAMOUNT < 0)
-                        payeeStats[trx.PAYEEID].first -= entry.SPLITTRANSAMOUNT * convRate;
+                        payeeStats[payee_id].first -= entry.SPLITTRANSAMOUNT * convRate;
                     else
-                        payeeStats[trx.PAYEEID].second -= entry.SPLITTRANSAMOUNT * convRate;
+                        payeeStats[payee_id].second -= entry.SPLITTRANSAMOUNT * convRate;
                 }
             }
         }
@@ -182,6 +182,19 @@ void mmPrintableBase::date_range(const mmDateRange* date_range, int selection)
     this->m_date_selection = selection;
 }
 
+/** Return the currency id of each account, of the selected accounts only if selected is set */
+std::map<int64, int64> mmPrintableBase::getAccountCurrencies(bool selected) const
+{
+    std::map<int64, int64> currencies;
+    for (const auto& account : Model_Account::instance().all())
+    {
+        if (selected && accountArray_ && wxNOT_FOUND == accountArray_->Index(account.ACCOUNTNAME))
+            continue;
+        currencies[account.ACCOUNTID] = account.CURRENCYID;
+    }
+    return currencies;
+}
+
 const wxString mmPrintableBase::getAccountNames() const
 {
     wxString accountsMsg;
@@ -265,6 +278,13 @@ void mmPrintableBase::setAccounts(int selection, const wxString& name)
     }
 }
 
+bool mmPrintableBase::progress(int done, int total)
+{
+    if (!m_cancelled && m_progress && !m_progress(done, total))
+        m_cancelled = true;
+    return !m_cancelled;
+}
+
 const wxString mmPrintableBase::getReportTitle(bool translate) const
 {
     wxString title = translate ? wxGetTranslation(m_title) : m_title;
@@ -287,7 +307,10 @@ mmGeneralReport::mmGeneralReport(const Model_Report::Data* report)
 wxString mmGeneralReport::getHTMLText()
 {
     wxString out;
-    int error = Model_Report::instance().get_html(this->m_report, out);
+    int error = Model_Report::instance().get_html(this->m_report, out
+        , [this](int rows) { return progress(rows); });
+    if (cancelled())
+        return wxEmptyString;
     if (error != 0) {
         const char* error_template = R"(
 <!DOCTYPE html>
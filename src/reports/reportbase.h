@@ -25,6 +25,7 @@
 #include "mmDateRange.h"
 #include "option.h"
 #include "model/Model_Report.h"
+#include <functional>
 class wxString;
 class wxArrayString;
 //----------------------------------------------------------------------------
@@ -47,6 +48,7 @@ public:
     int getChartSelection() const;
     int getForwardMonths() const;   
     const wxString getAccountNames() const;
+    std::map<int64, int64> getAccountCurrencies(bool selected = true) const;
     void chart(int selection);
     void setAccounts(int selection, const wxString& name);
     void setSelection(int64 sel);
@@ -57,6 +59,13 @@ public:
     void restoreReportSettings();
     void initReportSettings(const wxString& settings);
 
+    /** Called with the work done and the total (0 if unknown), returns false to cancel the run */
+    typedef std::function<bool(int done, int total)> Progress;
+    void setProgress(const Progress& progress);
+    /** To be called from long loops of getHTMLText(), false once the run is cancelled */
+    bool progress(int done, int total = 0);
+    bool cancelled() const;
+
 public:
     mmFilterTransactions m_filter;
     static const char * m_template;
@@ -114,6 +123,8 @@ private:
     int m_id = -1;
     int m_parameters = 0;
     wxString m_settings = "";
+    Progress m_progress;
+    bool m_cancelled = false;
 };
 
 inline void mmPrintableBase::setSelection(int64 sel) { m_date_selection = sel; }
@@ -127,6 +138,8 @@ inline void mmPrintableBase::initial_report(bool initial) { m_initial = initial;
 inline  int mmPrintableBase::report_parameters() { return m_parameters; }
 inline  const wxString mmPrintableBase::getReportSettings() const { return m_settings; }
 inline void mmPrintableBase::initReportSettings(const wxString & settings) { m_settings = settings; }
+inline void mmPrintableBase::setProgress(const Progress& progress) { m_progress = progress; m_cancelled = false; }
+inline bool mmPrintableBase::cancelled() const { return m_cancelled; }
 
 class mmGeneralReport : public mmPrintableBase
 {
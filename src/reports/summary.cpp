@@ -43,35 +43,11 @@ mmReportSummaryByDate::mmReportSummaryByDate(int mode)
 
 }
 
-std::map<wxDate, double> mmReportSummaryByDate::createCheckingBalanceMap(const Model_Account::Data& account)
-{
-    std::map<wxDate, double> balanceMap;
-    double balance = account.INITIALBAL;
-
-    for (const auto& tran : Model_Account::transactionsByDateTimeId(account))
-    {
-        wxDate date = Model_Checking::TRANSDATE(tran);
-        balance += Model_Checking::account_flow(tran, account.ACCOUNTID);
-        balanceMap[date] = balance;
-    } 
-    return balanceMap;
-}
-
-static bool sortFunction(const std::pair<wxDate, double> x, std::pair<wxDate, double> y)
-{
-    return x.first >= y.first;
-}
-
 double mmReportSummaryByDate::getCheckingDailyBalanceAt(const Model_Account::Data* account, const wxDate& date)
 {
-    std::map<wxDate, double> balanceMap = accountsBalanceMap[account->ACCOUNTID];
-
-    auto const& i = std::upper_bound(balanceMap.rbegin(), balanceMap.rend(), std::pair<wxDate, double>(date, 0), sortFunction);
-    if (i != balanceMap.rend())
-    {
-        return (*i).second;
-    }
-    return account->INITIALBAL;
+    // include every transaction of the day, whether or not TRANSDATE has a time part
+    const wxString date_iso = date.FormatISODate() + "T23:59:59";
+    return account->INITIALBAL + Model_Account::instance().balance_flow(account->ACCOUNTID, date_iso).second;
 }
 
 double mmReportSummaryByDate::getInvestingDailyBalanceAt(const Model_Account::Data* account, const wxDate& date)
@@ -94,22 +70,6 @@ std::pair<double, double> mmReportSummaryByDate::getDailyBalanceAt(const Model_A
     return bal;
 }
 
-double mmReportSummaryByDate::getDayRate(int64 currencyid, const wxDate& date)
-{
-    wxString key = wxString::Format("%lld_%s", currencyid, date.FormatDate());
-
-    auto i = currencyDateRateCache.find(key);
-    if (i != currencyDateRateCache.end())
-    {
-        return (*i).second;
-    }
-
-    double value = Model_CurrencyHistory::getDayRate(currencyid, date);
-    currencyDateRateCache[key] = value;
-
-    return value;
-}
-
 wxString mmReportSummaryByDate::getHTMLText()
 {
     mmHTMLBuilder   hb;
@@ -132,7 +92,6 @@ wxString mmReportSummaryByDate::getHTMLText()
     const auto name = wxString::Format(_t("Accounts Balance - %s"), mode_ == MONTHLY ? _t("Monthly Report") : _t("Yearly Report"));
     hb.addReportHeader(name);
 
-    currencyDateRateCache.clear();
     arHistory.clear();
 
     dateStart = wxDate::Today();
@@ -142,7 +101,6 @@ wxString mmReportSummaryByDate::getHTMLText()
         const wxDate accountOpeningDate = Model_Account::get_date_by_string(account.INITIALDATE);
         if (accountOpeningDate.IsEarlierThan(dateStart))
             dateStart = accountOpeningDate;
-        accountsBalanceMap[account.ACCOUNTID] = createCheckingBalanceMap(account);
         if (Model_Account::type_id(account) == Model_Account::TYPE_ID_INVESTMENT)
         {
             Model_Stock::Data_Set stocks = Model_Stock::instance().find(Model_Stock::HELDAT(account.id()));
@@ -190,8 +148,12 @@ wxString mmReportSummaryByDate::getHTMLText()
     }
     std::reverse(arDates.begin(), arDates.end());
 
+    int done = 0;
     for (const auto & end_date : arDates)
     {
+        if (!progress(done++, static_cast<int>(arDates.size())))
+            return wxEmptyString;
+
         double total = 0.0;
         double assetBalance = 0;
         // prepare columns for report: date, cash, checking, CC, loan, term, asset, shares, partial total, investment, grand total
@@ -202,16 +164,28 @@ wxString mmReportSummaryByDate::getHTMLText()
         if (mode_ == YEARLY)
             begin_date.SetMonth(wxDateTime::Jan);
 
+        const auto accounts = Model_Account::instance().all();
+        const auto assets = Model_Asset::instance().all();
+        std::vector<std::pair<int64, wxDate> > rateKeys;
+        for (const auto& account : accounts)
+            rateKeys.emplace_back(account.CURRENCYID, end_date);
+        for (const auto& asset : assets)
+            rateKeys.emplace_back(asset.CURRENCYID, end_date);
+        const std::vector<double> rates = Model_CurrencyHistory::getDayRates(rateKeys);
+        size_t rateIndex = 0;
+
         std::pair<double /*cash bal*/, double /*market bal*/> balancePerDay[Model_Account::TYPE_ID_size] = {};
-        for (const auto& account : Model_Account::instance().all())
+        for (const auto& account : accounts)
         {
-            balancePerDay[Model_Account::type_id(account)].first += getDailyBalanceAt(&account, end_date).first * getDayRate(account.CURRENCYID, end_date);
-            balancePerDay[Model_Account::type_id(account)].second += getDailyBalanceAt(&account, end_date).second * getDayRate(account.CURRENCYID, end_date);
+            const auto bal = getDailyBalanceAt(&account, end_date);
+            const double rate = rates[rateIndex++];
+            balancePerDay[Model_Account::type_id(account)].first += bal.first * rate;
+            balancePerDay[Model_Account::type_id(account)].second += bal.second * rate;
         }
 
-        for (const auto& asset : Model_Asset::instance().all())
+        for (const auto& asset : assets)
         {
-            assetBalance += Model_Asset::instance().valueAtDate(&asset, end_date).second * getDayRate(asset.CURRENCYID, end_date);
+            assetBalance += Model_Asset::instance().valueAtDate(&asset, end_date).second * rates[rateIndex++];
         }
 
         totBalanceEntry.values.push_back(balancePerDay[Model_Account::TYPE_ID_CASH].first);
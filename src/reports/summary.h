@@ -55,15 +55,11 @@ protected:
     enum TYPE { MONTHLY = 0, YEARLY };
 private:
     int mode_;
-    std::map<int64, std::map<wxDate, double>> accountsBalanceMap;
     mmHistoryData   arHistory;
-    std::map<wxString, double> currencyDateRateCache;
 
-    std::map<wxDate, double> createCheckingBalanceMap(const Model_Account::Data& account);
     double getCheckingDailyBalanceAt(const Model_Account::Data* account, const wxDate& date);
     double getInvestingDailyBalanceAt(const Model_Account::Data* account, const wxDate& date);
     std::pair<double, double> getDailyBalanceAt(const Model_Account::Data* account, const wxDate& date);
-    double getDayRate(int64 currencyid, const wxDate& date);
 };
 
 class mmReportSummaryByDateMontly : public mmReportSummaryByDate
@@ -152,8 +152,11 @@ table {
     }
 
     // Display the data for each row
+    int done = 0;
     for (auto& transaction : trans_)
     {
+        if (!progress(done++, static_cast<int>(trans_.size())))
+            return wxEmptyString;
         if (!transaction.DELETEDTIME.IsEmpty()) continue;
 
         wxString sortLabel = "ALL";
@@ -552,6 +555,7 @@ table {
 void mmReportTransactions::Run(wxSharedPtr<mmFilterTransactionsDialog>& dlg)
 {
     trans_.clear();
+    dlg.get()->mmCompileFilter();
     const auto splits = Model_Splittransaction::instance().get_all();
     const auto tags = Model_Taglink::instance().get_all(Model_Checking::refTypeName);
     bool combine_splits = dlg.get()->mmIsCombineSplitsChecked();
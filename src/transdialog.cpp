@@ -1037,15 +1037,15 @@ void mmTransDialog::OnCalculator(wxCommandEvent& WXUNUSED(event))
 void mmTransDialog::OnAutoTransNum(wxCommandEvent& WXUNUSED(event))
     {
     auto d = Model_Checking::TRANSDATE(m_fused_data).Subtract(wxDateSpan::Months(12));
+    const int first_day = Model_Checking::to_day(d);
     double next_number = 0, temp_num;
-    const auto numbers = Model_Checking::instance().find(
-        Model_Checking::ACCOUNTID(m_fused_data.ACCOUNTID, EQUAL)
-        , Model_Checking::TRANSDATE(d, GREATER_OR_EQUAL)
-        , Model_Checking::TRANSACTIONNUMBER("", NOT_EQUAL));
-    for (const auto &num : numbers)
+    const auto numbers = Model_Checking::instance().autocomplete_usage(
+        Model_Checking::AUTOCOMPLETE_NUMBER, m_fused_data.ACCOUNTID);
+    for (const auto& [number, usage] : numbers)
     {
-        if (!num.TRANSACTIONNUMBER.IsNumber()) continue;
-        if (num.TRANSACTIONNUMBER.ToDouble(&temp_num) && temp_num > next_number)
+        if (usage.last_day < first_day) continue;
+        if (!number.IsNumber()) continue;
+        if (number.ToDouble(&temp_num) && temp_num > next_number)
             next_number = temp_num;
     }
 
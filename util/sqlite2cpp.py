@@ -107,6 +107,17 @@ base_data_types_function = {
     'REAL': 'GetDouble',
 }
 
+# Secondary keys kept as hash indexes over the memory table (cache).
+# get_one() uses an index when its arguments cover all columns of the key.
+secondary_keys = {
+    'ACCOUNTLIST_V1': [['ACCOUNTNAME']],
+    'INFOTABLE_V1': [['INFONAME']],
+    'PAYEE_V1': [['PAYEENAME']],
+    'SETTING_V1': [['SETTINGNAME']],
+    'TAG_V1': [['TAGNAME']],
+    'TAGLINK_V1': [['REFTYPE', 'REFID']],
+}
+
 class DB_Table:
     """ Class: Defines the database table in SQLite3"""
     def __init__(self, table, fields, index, data):
@@ -115,6 +126,21 @@ class DB_Table:
         self._primay_key = [field['name'] for field in self._fields if field['pk']][0]
         self._index = index
         self._data = data
+        self._secondary_keys = secondary_keys.get(table.upper(), [])
+
+    def field_type(self, name):
+        """Return the c++ type of the named field"""
+        return [base_data_types_reverse[field['type']] for field in self._fields if field['name'] == name][0]
+
+    def key_expr(self, columns, prefix):
+        """Return the c++ expression building the hash key of a secondary index"""
+        parts = []
+        for col in columns:
+            if self.field_type(col) == 'wxString':
+                parts.append('%s%s.Lower()' % (prefix, col))  # match() compares strings case-insensitively
+            else:
+                parts.append('%s%s.ToString()' % (prefix, col))
+        return ' + "\\x1f" + '.join(parts)
 
     def generate_currency_table_data(self, sf1, utf_only):
         """Extract currency table data from table_v1
@@ -196,13 +222,33 @@ struct DB_Table_%s : public DB_Table
         }
     };
 
-    /** A container to hold a list of Data record pointers for the table in memory*/
+    /**
+    * A container to hold a list of Data record pointers for the table in memory.
+    * Each cached record knows its own slot in the cache, so that it can be
+    * located and released in constant time.
+    */
     typedef std::vector<Self::Data*> Cache;
-    typedef std::map<int64, Self::Data*> Index_By_Id;
+    typedef std::unordered_map<int64, Self::Data*, DB_Id_Hash> Index_By_Id;
     Cache cache_;
     Index_By_Id index_by_id_;
     Data* fake_; // in case the entity not found
+''' % (self._table, self._table)
+
+        for key in self._secondary_keys:
+            kname = '_'.join(key)
+            s += '''
+    /** Secondary index on (%s) over the indexed records in memory */
+    typedef std::unordered_multimap<wxString, Self::Data*> Index_By_%s;
+    Index_By_%s index_by_%s_;
+    static wxString key_%s(%s)
+    {
+        return %s;
+    }
+''' % (', '.join(key), kname, kname, kname, kname,
+          ', '.join(['const %s& %s' % (self.field_type(c), c) for c in key]),
+          self.key_expr(key, ''))
 
+        s += '''
     /** Destructor: clears any data records stored in memory */
     ~DB_Table_%s() 
     {
@@ -215,9 +261,56 @@ struct DB_Table_%s : public DB_Table
     {
         std::for_each(cache_.begin(), cache_.end(), std::mem_fn(&Data::destroy));
         cache_.clear();
-        index_by_id_.clear(); // no memory release since it just stores pointer and the according objects are in cache
+        index_by_id_.clear(); // no memory release since it just stores pointer and the according objects are in cache''' % self._table
+        for key in self._secondary_keys:
+            s += '''
+        index_by_%s_.clear();''' % '_'.join(key)
+        s += '''
+        destroy_statements();
+        journal(DB_Change::CHANGE_RESET, 0);
+    }
+
+    /** Take ownership of the record by placing it in the memory table (cache)*/
+    void attach(Self::Data* entity)
+    {
+        entity->slot_ = cache_.size();
+        cache_.push_back(entity);
     }
-''' % (self._table, self._table, self._table)
+
+    /** Release the record from the memory table (cache), filling its slot with the last record*/
+    void detach(Self::Data* entity)
+    {
+        Self::Data* last = cache_.back();
+        cache_[entity->slot_] = last;
+        last->slot_ = entity->slot_;
+        cache_.pop_back();
+        entity->slot_ = NO_SLOT;
+    }
+
+    /** Add the cached record to the memory table indexes*/
+    void index(Self::Data* entity)
+    {
+        index_by_id_.insert(std::make_pair(entity->id(), entity));'''
+        for key in self._secondary_keys:
+            kname = '_'.join(key)
+            s += '''
+        entity->key_%s_ = key_%s(%s);
+        index_by_%s_.insert(std::make_pair(entity->key_%s_, entity));''' % (kname, kname,
+                ', '.join(['entity->' + c for c in key]), kname, kname)
+        s += '''
+    }
+
+    /** Remove the cached record from the memory table indexes*/
+    void unindex(Self::Data* entity)
+    {
+        index_by_id_.erase(entity->id());'''
+        for key in self._secondary_keys:
+            kname = '_'.join(key)
+            s += '''
+        erase_from_index(index_by_%s_, entity->key_%s_, entity);''' % (kname, kname)
+        s += '''
+    }
+'''
 
         s += '''
     /** Creates the database table if the table does not exist*/
@@ -357,7 +450,14 @@ struct DB_Table_%s : public DB_Table
         friend struct DB_Table_%s;
         /** This is a instance pointer to itself in memory. */
         Self* table_;
-    ''' % self._table.upper()
+        /** Position of the record in the table cache, NO_SLOT if not owned by the cache. */
+        size_t slot_;''' % self._table.upper()
+        for key in self._secondary_keys:
+            s += '''
+        /** Key of the record in index_by_%s_, as of its last indexing. */
+        wxString key_%s_;''' % ('_'.join(key), '_'.join(key))
+        s += '''
+    '''
         for field in self._fields:
             s += '''
         %s %s;%s''' % (
@@ -405,6 +505,7 @@ struct DB_Table_%s : public DB_Table
         explicit Data(Self* table = nullptr ) 
         {
             table_ = table;
+            slot_ = NO_SLOT;
         '''
 
         for field in self._fields:
@@ -425,6 +526,7 @@ struct DB_Table_%s : public DB_Table
         explicit Data(wxSQLite3ResultSet& q, Self* table = nullptr )
         {
             table_ = table;
+            slot_ = NO_SLOT;
         '''
         for field in self._fields:
             func = base_data_types_function[field['type']]
@@ -434,7 +536,12 @@ struct DB_Table_%s : public DB_Table
         s += '''
         }
 
-        Data(const Data& other) = default;
+        Data(const Data& other)
+        {
+            table_ = other.table_;
+            slot_ = NO_SLOT; // a copy is never owned by the cache
+            *this = other;
+        }
 
         Data& operator=(const Data& other)
         {
@@ -591,7 +698,7 @@ struct DB_Table_%s : public DB_Table
     Self::Data* create()
     {
         Self::Data* entity = new Self::Data(this);
-        cache_.push_back(entity);
+        attach(entity);
         return entity;
     }
     
@@ -608,12 +715,13 @@ struct DB_Table_%s : public DB_Table
     /**
     * Saves the Data record to the database table.
     * Either create a new record or update the existing record.
-    * Remove old record from the memory table (cache)
+    * Update the cached record in place, or index a newly created one.
     */
     bool save(Self::Data* entity, wxSQLite3Database* db, bool force_insert = false)
     {
         wxString sql = wxEmptyString;
-        if (entity->id() <= 0 || force_insert) //  new & insert
+        const bool insert = entity->id() <= 0 || force_insert;
+        if (insert) //  new & insert
         {
             sql = "INSERT INTO %s(%s, %s) VALUES(%s)";
         }''' % (self._table, ', '.join([field['name']\
@@ -628,7 +736,7 @@ struct DB_Table_%s : public DB_Table
 
         try
         {
-            wxSQLite3Statement stmt = db->PrepareStatement(sql);
+            wxSQLite3Statement& stmt = statement(db, sql);
 ''' % (self._table, ', '.join([field['name'] + ' = ?'\
         for field in self._fields if not field['pk']]), self._primay_key)
 
@@ -641,15 +749,21 @@ struct DB_Table_%s : public DB_Table
             stmt.Bind(%d, entity->id() > 0 ? entity->%s : newId());
 
             stmt.ExecuteUpdate();
-            stmt.Finalize();
+            stmt.Reset();
 
             if (entity->id() > 0) // existent
             {
-                for(Cache::iterator it = cache_.begin(); it != cache_.end(); ++ it)
+                if (auto it = index_by_id_.find(entity->id()); it != index_by_id_.end())
                 {
-                    Self::Data* e = *it;
-                    if (e->id() == entity->id()) 
+                    Self::Data* e = it->second;
+                    unindex(e);
+                    if (e != entity)
                         *e = *entity;  // in-place update
+                    index(e);
+                }
+                else if (entity->slot_ != NO_SLOT)
+                {
+                    index(entity);
                 }
             }
         }
@@ -662,8 +776,10 @@ struct DB_Table_%s : public DB_Table
         if (entity->id() <= 0)
         {
             entity->id(db->GetLastRowId());
-            index_by_id_.insert(std::make_pair(entity->id(), entity));
+            if (entity->slot_ != NO_SLOT) // only records owned by the cache are indexed
+                index(entity);
         }
+        journal(insert ? DB_Change::CHANGE_INSERT : DB_Change::CHANGE_UPDATE, entity->id());
         return true;
     }
 ''' % (len(self._fields), self._primay_key, self._table)
@@ -676,27 +792,18 @@ struct DB_Table_%s : public DB_Table
         try
         {
             wxString sql = "DELETE FROM %s WHERE %s = ?";
-            wxSQLite3Statement stmt = db->PrepareStatement(sql);
+            wxSQLite3Statement& stmt = statement(db, sql);
             stmt.Bind(1, id);
             stmt.ExecuteUpdate();
-            stmt.Finalize();
+            stmt.Reset();
 
-            Cache c;
-            for(Cache::iterator it = cache_.begin(); it != cache_.end(); ++ it)
+            if (auto it = index_by_id_.find(id); it != index_by_id_.end())
             {
-                Self::Data* entity = *it;
-                if (entity->id() == id) 
-                {
-                    index_by_id_.erase(entity->id());
-                    delete entity;
-                }
-                else 
-                {
-                    c.push_back(entity);
-                }
+                Self::Data* entity = it->second;
+                unindex(entity);
+                if (entity->slot_ != NO_SLOT) detach(entity);
+                delete entity;
             }
-            cache_.clear();
-            cache_.swap(c);
         }
         catch(const wxSQLite3Exception &e) 
         { 
@@ -704,15 +811,18 @@ struct DB_Table_%s : public DB_Table
             return false;
         }
 
+        journal(DB_Change::CHANGE_REMOVE, id);
         return true;
     }
 
     /** Remove the Data record from the database and the memory table (cache) */
     bool remove(Self::Data* entity, wxSQLite3Database* db)
     {
+        auto it = index_by_id_.find(entity->id());
+        const bool cached = (it != index_by_id_.end() && it->second == entity);
         if (remove(entity->id(), db))
         {
-            entity->id(-1);
+            if (!cached) entity->id(-1); // a cached entity has been released
             return true;
         }
 
@@ -721,21 +831,50 @@ struct DB_Table_%s : public DB_Table
 ''' % (self._table, self._primay_key, self._table)
 
         s += '''
+    /**
+    * Search the memory table (Cache) for the first data record matching all arguments.
+    * A secondary index is used when the arguments cover its columns with EQUAL.
+    */
     template<typename... Args>
     Self::Data* get_one(const Args& ... args)
-    {
-        for (auto& [_, item] : index_by_id_)
+    {'''
+        for key in self._secondary_keys:
+            kname = '_'.join(key)
+            s += '''
+        if constexpr (%s)
         {
-            if (item->id() > 0 && match(item, args...)) 
+            %s
+            if (%s)
             {
-                ++ hit_;
-                return item;
+                auto range = index_by_%s_.equal_range(key_%s(%s));
+                // equal keys resolve to the lowest id, as a scan in id order would
+                Self::Data* found = 0;
+                for (auto it = range.first; it != range.second; ++ it)
+                {
+                    if (match(it->second, args...) && (!found || it->second->id() < found->id()))
+                        found = it->second;
+                }
+
+                if (found) ++ hit_; else ++ miss_;
+                return found;
             }
         }
+''' % (' && '.join(['has_column<Self::%s, Args...>' % c for c in key]),
+          '\n            '.join(['const Self::%s* %s_arg = column_arg<Self::%s>(args...);' % (c, c, c) for c in key]),
+          ' && '.join(['%s_arg->op_ == EQUAL' % c for c in key]),
+          kname, kname, ', '.join(['%s_arg->v_' % c for c in key]))
+        s += '''
+        // the id index is unordered, keep the lowest id among the matches
+        Self::Data* found = 0;
+        for (auto& [_, item] : index_by_id_)
+        {
+            if (item->id() > 0 && match(item, args...) && (!found || item->id() < found->id()))
+                found = item;
+        }
 
-        ++ miss_;
+        if (found) ++ hit_; else ++ miss_;
 
-        return 0;
+        return found;
     }'''
 
         s += '''
@@ -763,17 +902,17 @@ struct DB_Table_%s : public DB_Table
         wxString where = wxString::Format(" WHERE %s = ?", PRIMARY::name().utf8_str());
         try
         {
-            wxSQLite3Statement stmt = db->PrepareStatement(this->query() + where);
+            wxSQLite3Statement& stmt = statement(db, this->query() + where);
             stmt.Bind(1, id);
 
             wxSQLite3ResultSet q = stmt.ExecuteQuery();
             if(q.NextRow())
             {
                 entity = new Self::Data(q, this);
-                cache_.push_back(entity);
-                index_by_id_.insert(std::make_pair(id, entity));
+                attach(entity);
+                index(entity);
             }
-            stmt.Finalize();
+            stmt.Reset();
         }
         catch(const wxSQLite3Exception &e) 
         { 
@@ -803,7 +942,7 @@ struct DB_Table_%s : public DB_Table
         wxString where = wxString::Format(" WHERE %s = ?", PRIMARY::name().utf8_str());
         try
         {
-            wxSQLite3Statement stmt = db->PrepareStatement(this->query() + where);
+            wxSQLite3Statement& stmt = statement(db, this->query() + where);
             stmt.Bind(1, id);
 
             wxSQLite3ResultSet q = stmt.ExecuteQuery();
@@ -811,7 +950,7 @@ struct DB_Table_%s : public DB_Table
             {
                 entity = new Self::Data(q, this);
             }
-            stmt.Finalize();
+            stmt.Reset();
         }
         catch(const wxSQLite3Exception &e) 
         { 
@@ -864,8 +1003,11 @@ def generate_base_class(header, fields=set):
     """Generate the base class"""
     code = header + '''#pragma once
 
+#include <array>
 #include <vector>
 #include <map>
+#include <unordered_map>
+#include <type_traits>
 #include <random>
 #include <algorithm>
 #include <functional>
@@ -896,18 +1038,146 @@ struct DB_Column
     {}
 };
 
+/** Hash of the primary key, used by the in-memory index of each table */
+struct DB_Id_Hash
+{
+    size_t operator()(const int64& id) const
+    {
+        return std::hash<wxLongLong_t>()(id.GetValue());
+    }
+};
+
 static int64 ticks_last_ = 0;
+
+/** One entry of the change journal of a table */
+struct DB_Change
+{
+    enum TYPE { CHANGE_INSERT = 0, CHANGE_UPDATE, CHANGE_REMOVE, CHANGE_RESET };
+    size_t generation;
+    TYPE type;
+    int64 id; // the primary key, 0 for CHANGE_RESET
+};
     
 struct DB_Table
 {
-    DB_Table(): hit_(0), miss_(0), skip_(0) {};
+    static const size_t NO_SLOT = static_cast<size_t>(-1);
+
+    DB_Table(): hit_(0), miss_(0), skip_(0), generation_(0), stmt_hit_(0), stmt_miss_(0), stmt_db_(nullptr) {};
     virtual ~DB_Table() {};
     wxString query_;
     size_t hit_, miss_, skip_;
+    size_t generation_; // advanced by every save, remove and cache reset of the table
+
+    /** Change counter of the table, lets derived data tell whether it is stale */
+    size_t generation() const { return generation_; }
+
+    /** Latest changes of the table, at generation % JOURNAL_SIZE */
+    static const size_t JOURNAL_SIZE = 256;
+    std::array<DB_Change, JOURNAL_SIZE> journal_;
+
+    /** Advance the generation and record the change in the journal */
+    void journal(DB_Change::TYPE type, const int64& id)
+    {
+        ++ generation_;
+        journal_[generation_ % JOURNAL_SIZE] = { generation_, type, id };
+    }
+
+    /**
+    * Append the changes made after generation since, oldest first.
+    * Return false when the journal no longer holds all of them or one is a cache reset,
+    * then derived data has to be rebuilt.
+    */
+    bool changes_since(size_t since, std::vector<DB_Change>& changes) const
+    {
+        if (since > generation_ || generation_ - since > JOURNAL_SIZE)
+            return false;
+        for (size_t g = since + 1; g <= generation_; ++g)
+        {
+            const DB_Change& change = journal_[g % JOURNAL_SIZE];
+            if (change.type == DB_Change::CHANGE_RESET)
+                return false;
+            changes.push_back(change);
+        }
+        return true;
+    }
+
     virtual wxString query() const { return this->query_; }
     virtual size_t num_columns() const = 0;
     virtual wxString name() const = 0;
 
+    /** Prepared statements of the table, keyed by their SQL text */
+    typedef std::map<wxString, wxSQLite3Statement> Statement_Cache;
+    Statement_Cache stmt_cache_;
+    size_t stmt_hit_, stmt_miss_;
+    wxSQLite3Database* stmt_db_; // connection the cached statements belong to
+
+    /**
+    * Return the prepared statement for the sql text, ready to be bound.
+    * The statement is prepared on first use and reset on every reuse.
+    */
+    wxSQLite3Statement& statement(wxSQLite3Database* db, const wxString& sql)
+    {
+        if (db != stmt_db_)
+        {
+            destroy_statements();
+            stmt_db_ = db;
+        }
+
+        if (auto it = stmt_cache_.find(sql); it != stmt_cache_.end())
+        {
+            ++ stmt_hit_;
+            it->second.Reset();
+            return it->second;
+        }
+
+        ++ stmt_miss_;
+        return stmt_cache_.insert(std::make_pair(sql, db->PrepareStatement(sql))).first->second;
+    }
+
+    /** Finalize all cached statements, must be called before the connection is closed */
+    void destroy_statements()
+    {
+        stmt_cache_.clear();
+        stmt_db_ = nullptr;
+    }
+
+#ifndef NDEBUG
+    /** Index advisor: query plan and use count of each WHERE signature issued by find_by() */
+    struct Query_Plan
+    {
+        wxString detail;
+        size_t count = 0;
+        bool scan = false;
+    };
+    std::map<wxString, Query_Plan> query_plans_;
+
+    /** Record one use of the WHERE signature, explaining its plan on first sight */
+    void advise(wxSQLite3Database* db, const wxString& where)
+    {
+        Query_Plan& plan = query_plans_[where];
+        if (plan.count++ > 0) return;
+
+        try
+        {
+            wxSQLite3ResultSet q = db->ExecuteQuery("EXPLAIN QUERY PLAN " + this->query() + where);
+            while (q.NextRow())
+            {
+                const wxString detail = q.GetAsString(3);
+                plan.detail += (plan.detail.empty() ? "" : "; ") + detail;
+                if (detail.StartsWith("SCAN") && !detail.Contains(" INDEX "))
+                    plan.scan = true;
+            }
+        }
+        catch (const wxSQLite3Exception& e)
+        {
+            plan.detail = e.GetMessage();
+        }
+
+        if (plan.scan)
+            wxLogDebug("%s: full table scan for%s(%s)", this->name(), where, plan.detail);
+    }
+#endif
+
     bool exists(wxSQLite3Database* db) const
     {
        return db->TableExists(this->name()); 
@@ -989,9 +1259,15 @@ const typename TABLE::Data_Set find_by(TABLE* table, wxSQLite3Database* db, bool
     typename TABLE::Data_Set result;
     try
     {
-        wxString query = table->query() + " WHERE ";
-        condition(query, op_and, args...);
-        wxSQLite3Statement stmt = db->PrepareStatement(query);
+        wxString where = " WHERE ";
+        condition(where, op_and, args...);
+#ifndef NDEBUG
+        table->advise(db, where);
+#endif
+        const wxString query = table->query() + where;
+        // the condition text only depends on the column pack and operators,
+        // so it doubles as the statement cache key
+        wxSQLite3Statement& stmt = table->statement(db, query);
         bind(stmt, 1, args...);
 
         wxSQLite3ResultSet q = stmt.ExecuteQuery();
@@ -1002,7 +1278,7 @@ const typename TABLE::Data_Set find_by(TABLE* table, wxSQLite3Database* db, bool
             result.push_back(std::move(entity));
         }
 
-        q.Finalize();
+        stmt.Reset();
     }
     catch(const wxSQLite3Exception &e) 
     { 
@@ -1012,6 +1288,41 @@ const typename TABLE::Data_Set find_by(TABLE* table, wxSQLite3Database* db, bool
     return result;
 }
 
+/** True when the column type C is one of the argument types */
+template<typename C, typename... Args>
+constexpr bool has_column = (std::is_same_v<C, Args> || ...);
+
+template<typename C, typename Arg>
+const C* column_arg_if(const Arg& arg)
+{
+    if constexpr (std::is_same_v<C, Arg>) return &arg;
+    else return nullptr;
+}
+
+/** Return the first argument of column type C, or nullptr */
+template<typename C, typename... Args>
+const C* column_arg(const Args&... args)
+{
+    const C* found = nullptr;
+    ((found = found ? found : column_arg_if<C>(args)), ...);
+    return found;
+}
+
+/** Remove the entry of the record from a secondary index */
+template<class INDEX, class DATA>
+void erase_from_index(INDEX& index, const typename INDEX::key_type& key, const DATA* entity)
+{
+    auto range = index.equal_range(key);
+    for (auto it = range.first; it != range.second; ++ it)
+    {
+        if (it->second == entity)
+        {
+            index.erase(it);
+            return;
+        }
+    }
+}
+
 template<class DATA, typename Arg1>
 bool match(const DATA* data, const Arg1& arg1)
 {